@@ -0,0 +1,637 @@
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include "AMSBench.hpp"
+#include <ErrorSystem.hpp>
+#include <SmallTimeAndDate.hpp>
+#include <ModuleController.hpp>
+#include <ModCache.hpp>
+#include <ModBundleIndex.hpp>
+#include <ModBundleIndexSnapshot.hpp>
+#include <Module.hpp>
+#include <ShellProcessor.hpp>
+#include <HostGroup.hpp>
+#include <Host.hpp>
+#include <FSIndex.hpp>
+#include <Shell.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <ftw.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+MAIN_ENTRY(CAMSBench)
+
+//------------------------------------------------------------------------------
+
+// number of modules used by per-module benchmarks
+#define BENCH_MAX_MODULES   100
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CAMSBench::CAMSBench(void)
+{
+    NullFile = NULL;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+int CAMSBench::Init(int argc, char* argv[])
+{
+    // encode program options
+    int result = Options.ParseCmdLine(argc,argv);
+
+    // should we exit or was it error?
+    if( result != SO_CONTINUE ) return(result);
+
+    // progress goes to stderr, stdout is reserved for results
+    Console.Attach(stderr);
+
+    // attach verbose stream to terminal stream and set desired verbosity level
+    vout.Attach(Console);
+    if( Options.GetOptVerbose() ) {
+        vout.Verbosity(CVerboseStr::high);
+    } else {
+        vout.Verbosity(CVerboseStr::low);
+    }
+
+    // library output is discarded
+    NullFile = fopen("/dev/null","w");
+    if( NullFile == NULL ){
+        ES_ERROR("unable to open /dev/null");
+        return(SO_USER_ERROR);
+    }
+    NullConsole.Attach(NullFile);
+    nout.Attach(NullConsole);
+    nout.Verbosity(CVerboseStr::low);
+
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-bench (AMS utility) started at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    vout << low;
+
+    return(SO_CONTINUE);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSBench::Run(void)
+{
+    WorkDir = Options.GetOptWorkDir();
+    if( WorkDir == NULL ){
+        WorkDir = "/tmp/ams-bench.";
+        CSmallString pid;
+        pid.IntToStr(getpid());
+        WorkDir = WorkDir + pid;
+    }
+
+    vout << endl;
+    vout << "# Generating synthetic data in '" << WorkDir << "' ..." << endl;
+    vout << "  > Bundles       = " << Options.GetOptNumOfBundles() << endl;
+    vout << "  > Modules       = " << Options.GetOptNumOfModules() << " per bundle" << endl;
+    vout << "  > Builds        = " << Options.GetOptNumOfBuilds() << " per module" << endl;
+    vout << "  > Arch tokens   = " << Options.GetOptNumOfTokens() << endl;
+
+    if( MakeDirs(WorkDir) == false ) return(false);
+    if( GenerateBundles() == false ) return(false);
+    if( GenerateHostsConfig() == false ) return(false);
+    if( GenerateSoftRepo() == false ) return(false);
+    if( GenerateIndexes() == false ) return(false);
+
+    vout << endl;
+    vout << "# Running benchmarks (" << Options.GetOptNumOfRepeats() << " iterations each) ..." << endl;
+
+    BenchLoadAndMergeBundles();
+    BenchGetBuildsForCGen();
+    BenchAddModule();
+    BenchBuildEnvironment();
+    BenchCalculateBuildHash();
+    BenchIndexLoadAndDiff();
+    BenchIndexSnapshotDiff();
+    BenchPathListEdit();
+
+    // print results
+    if( Options.GetOptOutput() == "-" ){
+        for(const std::string& line : Results){
+            printf("%s\n",line.c_str());
+        }
+    } else {
+        ofstream ofs(Options.GetOptOutput());
+        for(const std::string& line : Results){
+            ofs << line << endl;
+        }
+        if( ! ofs ){
+            CSmallString error;
+            error << "unable to write results into '" << Options.GetOptOutput() << "'";
+            ES_ERROR(error);
+            return(false);
+        }
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+static int RemoveNode(const char* p_path,const struct stat* p_stat,int flag,struct FTW* p_ftw)
+{
+    return(remove(p_path));
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::Finalize(void)
+{
+    if( (WorkDir != NULL) && (Options.GetOptKeep() == false) ){
+        nftw(WorkDir,RemoveNode,64,FTW_DEPTH | FTW_PHYS);
+    }
+
+    if( NullFile != NULL ) fclose(NullFile);
+
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-bench (AMS utility) terminated at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    if( ErrorSystem.IsError() || (ErrorSystem.IsAnyRecord() && Options.GetOptVerbose()) ){
+        vout << low;
+        ErrorSystem.PrintErrors(vout);
+    }
+
+    vout << endl;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CAMSBench::GenerateBundles(void)
+{
+    int nmods   = Options.GetOptNumOfModules();
+    int nbuilds = Options.GetOptNumOfBuilds();
+
+    for(int b=0; b < Options.GetOptNumOfBundles(); b++){
+        CFileName bname;
+        bname << "bench" << b;
+        CFileName config_dir = WorkDir / "bundles" / bname / "_ams_bundle";
+        if( MakeDirs(config_dir) == false ) return(false);
+
+        stringstream config;
+        config << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl;
+        char id[64];
+        snprintf(id,sizeof(id),"00000000-0000-0000-0000-%012d",b);
+        config << "<bundle name=\"" << bname << "\" id=\"" << id << "\">" << endl;
+        config << "  <maintainer name=\"AMS Bench\" email=\"bench@localhost\"/>" << endl;
+        config << "</bundle>" << endl;
+        if( WriteFile(config_dir / "config.xml",config.str()) == false ) return(false);
+
+        // bundles overlap by half of their modules
+        stringstream cache;
+        cache << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl;
+        cache << "<!-- synthetic cache generated by ams-bench -->" << endl;
+        cache << "<cache>" << endl;
+        for(int i = b*nmods/2; i < b*nmods/2 + nmods; i++){
+            CSmallString name = GetModuleName(i);
+            cache << "  <module name=\"" << name << "\">" << endl;
+            cache << "    <default ver=\"1." << (nbuilds-1)/2 << "\" arch=\"auto\" mode=\"auto\"/>" << endl;
+            cache << "    <categories><category name=\"cat" << i % 20 << "\"/></categories>" << endl;
+            if( i % 10 == 0 ){
+                cache << "    <acl default=\"allow\"><deny group=\"ams-bench-nobody\"/></acl>" << endl;
+            }
+            cache << "    <builds>" << endl;
+            for(int j=0; j < nbuilds; j++){
+                cache << "      <build ver=\"1." << j/2 << "\" arch=\"" << GetBuildArch(i,j)
+                      << "\" mode=\"single\" verindx=\"" << j/2 << "\">" << endl;
+                cache << "        <setup>" << endl;
+                cache << "          <variable name=\"PATH\" value=\"/soft/" << name << "/1." << j/2
+                      << "/bin\" operation=\"prepend\" priority=\"modaction\"/>" << endl;
+                cache << "          <variable name=\"LD_LIBRARY_PATH\" value=\"/soft/" << name << "/1." << j/2
+                      << "/lib\" operation=\"prepend\" priority=\"modaction\"/>" << endl;
+                cache << "          <variable name=\"AMS_PACKAGE_DIR\" value=\"" << name << "/1." << j/2
+                      << "/single\" operation=\"set\" priority=\"modaction\"/>" << endl;
+                cache << "        </setup>" << endl;
+                if( j == nbuilds-1 ){
+                    cache << "        <acl default=\"deny\"><allow group=\"ams-bench-nobody\"/></acl>" << endl;
+                }
+                cache << "      </build>" << endl;
+            }
+            cache << "    </builds>" << endl;
+            cache << "  </module>" << endl;
+        }
+        cache << "</cache>" << endl;
+        if( WriteFile(config_dir / "cache.xml",cache.str()) == false ) return(false);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSBench::GenerateHostsConfig(void)
+{
+    stringstream config;
+    config << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl;
+    config << "<config>" << endl;
+    config << "  <tokens>" << endl;
+    for(int k=0; k < Options.GetOptNumOfTokens(); k++){
+        config << "    <token name=\"t" << k << "\" score=\"" << k+1 << "\"/>" << endl;
+    }
+    config << "  </tokens>" << endl;
+    config << "  <modes>" << endl;
+    config << "    <cmode name=\"single\"><one score=\"100\"/><lem score=\"50\"/></cmode>" << endl;
+    config << "    <cmode name=\"para\"><gto score=\"100\"/></cmode>" << endl;
+    config << "  </modes>" << endl;
+    config << "</config>" << endl;
+
+    CFileName config_file = WorkDir / "hosts.xml";
+    if( WriteFile(config_file,config.str()) == false ) return(false);
+
+    HostGroup.InitHostsConfig(config_file);
+    for(int k=0; k < Options.GetOptNumOfTokens(); k++){
+        CSmallString token;
+        token << "t" << k;
+        Host.AddArchToken(token);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSBench::GenerateSoftRepo(void)
+{
+    int nmods = std::min(Options.GetOptNumOfModules(),BENCH_MAX_MODULES);
+
+    for(int i=0; i < nmods; i++){
+        for(int j=0; j < Options.GetOptNumOfBuilds(); j += 2){
+            CFileName ver;
+            ver << "1." << j/2;
+            CFileName build_dir = WorkDir / "softrepo" / CFileName(GetModuleName(i)) / ver / "single";
+            if( MakeDirs(build_dir / "bin") == false ) return(false);
+            if( MakeDirs(build_dir / "lib") == false ) return(false);
+            for(int f=0; f < 4; f++){
+                CFileName fname;
+                fname << "file" << f;
+                if( WriteFile(build_dir / "bin" / fname,"#!/bin/sh\n") == false ) return(false);
+                if( WriteFile(build_dir / "lib" / fname,"") == false ) return(false);
+            }
+        }
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSBench::GenerateIndexes(void)
+{
+    CModBundleIndex old_index;
+    CModBundleIndex new_index;
+
+    int n = 0;
+    for(int i=0; i < Options.GetOptNumOfModules(); i++){
+        for(int j=0; j < Options.GetOptNumOfBuilds(); j++){
+            CSmallString build_id;
+            build_id << GetModuleName(i) << ":1." << j/2 << ":" << GetBuildArch(i,j) << ":single";
+            CFileName ver;
+            ver << "1." << j/2;
+            CFileName path = CFileName("/soft") / CFileName(GetModuleName(i)) / ver;
+
+            char hash[41];
+            snprintf(hash,sizeof(hash),"%040x",n);
+
+            // 5% removed, 5% modified, 5% added
+            if( n % 20 != 0 ){
+                old_index.Paths[build_id] = path;
+                old_index.Hashes[build_id] = hash;
+            }
+            if( n % 20 != 10 ){
+                new_index.Paths[build_id] = path;
+                new_index.Hashes[build_id] = hash;
+                if( n % 20 == 5 ) new_index.Hashes[build_id] = std::string(hash).replace(0,1,"f");
+            }
+            n++;
+        }
+    }
+
+    if( old_index.SaveIndex(WorkDir / "index.old") == false ) return(false);
+    if( new_index.SaveIndex(WorkDir / "index.new") == false ) return(false);
+    if( old_index.SaveSnapshot(WorkDir / "index.old.snap") == false ) return(false);
+    if( new_index.SaveSnapshot(WorkDir / "index.new.snap") == false ) return(false);
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CAMSBench::BenchLoadAndMergeBundles(void)
+{
+    CSmallString bundle_names;
+    for(int b=0; b < Options.GetOptNumOfBundles(); b++){
+        if( b > 0 ) bundle_names << ",";
+        bundle_names << "bench" << b;
+    }
+    ModuleController.InitModuleControllerConfig(bundle_names,WorkDir / "bundles");
+
+    Measure("bundles-load-merge",
+            [](){},
+            [](){
+                ModuleController.LoadBundles(EMBC_SMALL);
+                ModuleController.MergeBundles();
+            });
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::BenchGetBuildsForCGen(void)
+{
+    Measure("builds-for-cgen",
+            [](){},
+            [](){
+                std::list<CSmallString> builds;
+                ModCache.GetBuildsForCGen(builds,3);
+            });
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::BenchAddModule(void)
+{
+    int nmods = std::min(Options.GetOptNumOfModules(),BENCH_MAX_MODULES);
+
+    Module.SetFlags(MFB_USER);
+    Module.SetPrintLevel(EAPL_NONE);
+
+    Measure("module-add-auto",
+            [this,nmods](){
+                for(int i=0; i < nmods; i++){
+                    Module.RemoveModule(nout,GetModuleName(i));
+                }
+                ShellProcessor.RollBack();
+            },
+            [this,nmods](){
+                for(int i=0; i < nmods; i++){
+                    Module.AddModule(nout,GetModuleName(i),false,false);
+                }
+            });
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::BenchBuildEnvironment(void)
+{
+    int nmods = std::min(Options.GetOptNumOfModules(),BENCH_MAX_MODULES);
+
+    // shell script is discarded
+    fflush(stdout);
+    int stdout_fd = dup(STDOUT_FILENO);
+    dup2(fileno(NullFile),STDOUT_FILENO);
+
+    Measure("shell-build-environment",
+            [this,nmods](){
+                for(int i=0; i < nmods; i++){
+                    Module.RemoveModule(nout,GetModuleName(i));
+                }
+                ShellProcessor.RollBack();
+                for(int i=0; i < nmods; i++){
+                    Module.AddModule(nout,GetModuleName(i),false,false);
+                }
+            },
+            [](){
+                ShellProcessor.BuildEnvironment();
+                fflush(stdout);
+            });
+
+    dup2(stdout_fd,STDOUT_FILENO);
+    close(stdout_fd);
+    ShellProcessor.RollBack();
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::BenchCalculateBuildHash(void)
+{
+    int nmods = std::min(Options.GetOptNumOfModules(),BENCH_MAX_MODULES);
+
+    Measure("fsindex-build-hash",
+            [](){},
+            [this,nmods](){
+                CFSIndex index;
+                index.RootDir = WorkDir / "softrepo";
+                index.PersonalBundle = false;
+                for(int i=0; i < nmods; i++){
+                    for(int j=0; j < Options.GetOptNumOfBuilds(); j += 2){
+                        CFileName ver;
+                        ver << "1." << j/2;
+                        index.CalculateBuildHash(CFileName(GetModuleName(i)) / ver / "single");
+                    }
+                }
+            });
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::BenchIndexLoadAndDiff(void)
+{
+    Measure("index-load-diff",
+            [](){},
+            [this](){
+                CModBundleIndex old_index;
+                CModBundleIndex new_index;
+                old_index.LoadIndex(WorkDir / "index.old");
+                new_index.LoadIndex(WorkDir / "index.new");
+                new_index.Diff(old_index,nout,false,false,false);
+            });
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::BenchIndexSnapshotDiff(void)
+{
+    Measure("index-snapshot-diff",
+            [](){},
+            [this](){
+                CModBundleIndexSnapshot old_index;
+                CModBundleIndexSnapshot new_index;
+                old_index.OpenIndex(WorkDir / "index.old.snap");
+                new_index.OpenIndex(WorkDir / "index.new.snap");
+                new_index.Diff(old_index,nout,false,false,false);
+            });
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSBench::BenchPathListEdit(void)
+{
+    int nmods = std::min(Options.GetOptNumOfModules(),BENCH_MAX_MODULES);
+
+    // PATH-like list with one item per module of all bundles (tens of kB)
+    CSmallString path;
+    for(int b=0; b < Options.GetOptNumOfBundles(); b++){
+        for(int i=0; i < Options.GetOptNumOfModules(); i++){
+            if( path != NULL ) path << ":";
+            path << "/software/ams/bundle" << b << "/" << GetModuleName(i) << "/1.0/x86_64/single/bin";
+        }
+    }
+
+    // what _ams-module-var does for prepend: remove the item and prepend it
+    Measure("shell-path-edit",
+            [](){},
+            [this,nmods,&path](){
+                CSmallString list = path;
+                std::vector<CSmallString> removed(1);
+                for(int i=0; i < nmods; i++){
+                    removed[0] = CSmallString("/software/ams/bundle0/") + GetModuleName(i) + "/1.0/x86_64/single/bin";
+                    list = CShell::EditValueList(list,removed,removed[0],NULL,":");
+                }
+            });
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CAMSBench::Measure(const char* name,const std::function<void(void)>& setup,
+                        const std::function<void(void)>& body)
+{
+    vout << "  > " << name << " ..." << endl;
+
+    // warm-up
+    setup();
+    body();
+
+    std::vector<double> times;
+    for(int r=0; r < Options.GetOptNumOfRepeats(); r++){
+        setup();
+        struct timespec begin, end;
+        clock_gettime(CLOCK_MONOTONIC,&begin);
+        body();
+        clock_gettime(CLOCK_MONOTONIC,&end);
+        times.push_back((end.tv_sec - begin.tv_sec)*1e6 + (end.tv_nsec - begin.tv_nsec)*1e-3);
+    }
+
+    std::sort(times.begin(),times.end());
+    double sum = 0.0;
+    for(double t : times) sum += t;
+    size_t n = times.size();
+    double median = (n % 2 == 1) ? times[n/2] : 0.5*(times[n/2-1] + times[n/2]);
+
+    // keep keys and their order stable - the output is compared by scripts
+    char line[1024];
+    snprintf(line,sizeof(line),
+             "{\"benchmark\":\"%s\",\"bundles\":%d,\"modules\":%d,\"builds\":%d,\"tokens\":%d,"
+             "\"iterations\":%d,\"min_us\":%.1f,\"median_us\":%.1f,\"mean_us\":%.1f,\"max_us\":%.1f}",
+             name,Options.GetOptNumOfBundles(),Options.GetOptNumOfModules(),
+             Options.GetOptNumOfBuilds(),Options.GetOptNumOfTokens(),(int)n,
+             times.front(),median,sum/n,times.back());
+    Results.push_back(line);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+const CSmallString CAMSBench::GetModuleName(int i) const
+{
+    char name[32];
+    snprintf(name,sizeof(name),"m%05d",i);
+    return(name);
+}
+
+//------------------------------------------------------------------------------
+
+const CSmallString CAMSBench::GetBuildArch(int i,int j) const
+{
+    int ntokens = Options.GetOptNumOfTokens();
+
+    // every third build requires a token that the host does not have
+    CSmallString arch;
+    arch << "t" << (i+j) % ntokens;
+    if( j % 3 == 2 ){
+        arch << "#gpu";
+    } else if( j % 2 == 1 ){
+        arch << "#t" << (i+j+1) % ntokens;
+    }
+    return(arch);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSBench::WriteFile(const CFileName& name,const std::string& content)
+{
+    ofstream ofs(name);
+    ofs << content;
+    if( ! ofs ){
+        CSmallString error;
+        error << "unable to write file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSBench::MakeDirs(const CFileName& path)
+{
+    std::string spath(path);
+    for(size_t pos = 1; pos <= spath.size(); pos++){
+        if( (pos < spath.size()) && (spath[pos] != '/') ) continue;
+        std::string dir = spath.substr(0,pos);
+        if( (mkdir(dir.c_str(),0755) != 0) && (errno != EEXIST) ){
+            CSmallString error;
+            error << "unable to create directory '" << dir.c_str() << "' (" << strerror(errno) << ")";
+            ES_ERROR(error);
+            return(false);
+        }
+    }
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,96 @@
+#ifndef AMSBenchH
+#define AMSBenchH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include "AMSBenchOptions.hpp"
+#include <VerboseStr.hpp>
+#include <TerminalStr.hpp>
+#include <FileName.hpp>
+#include <functional>
+#include <ostream>
+#include <list>
+
+// -----------------------------------------------------------------------------
+
+class CAMSBench {
+public:
+// constructor -----------------------------------------------------------------
+        CAMSBench(void);
+
+// main methods ----------------------------------------------------------------
+    /// init options
+    int Init(int argc,char* argv[]);
+
+    /// main part of program
+    bool Run(void);
+
+    /// finalize
+    void Finalize(void);
+
+// section of private data -----------------------------------------------------
+private:
+    CAMSBenchOptions    Options;
+    CTerminalStr        Console;
+    CVerboseStr         vout;
+    CTerminalStr        NullConsole;        // sink for the library output
+    CVerboseStr         nout;
+    FILE*               NullFile;
+
+    CFileName           WorkDir;
+    std::list<std::string>  Results;        // JSON lines
+
+    // synthetic data ----------------------------
+    /// create bundles with modules, builds, and ACLs
+    bool GenerateBundles(void);
+
+    /// create hosts config with architecture tokens and parallel modes
+    bool GenerateHostsConfig(void);
+
+    /// create software tree for build hashes
+    bool GenerateSoftRepo(void);
+
+    /// create two slightly different indexes
+    bool GenerateIndexes(void);
+
+    // benchmarks --------------------------------
+    void BenchLoadAndMergeBundles(void);
+    void BenchAddModule(void);
+    void BenchGetBuildsForCGen(void);
+    void BenchBuildEnvironment(void);
+    void BenchCalculateBuildHash(void);
+    void BenchIndexLoadAndDiff(void);
+    void BenchIndexSnapshotDiff(void);
+    void BenchPathListEdit(void);
+
+    /// run benchmark - setup is not measured
+    void Measure(const char* name,const std::function<void(void)>& setup,
+                 const std::function<void(void)>& body);
+
+    // helpers ---------------------------------
+    const CSmallString GetModuleName(int i) const;
+    const CSmallString GetBuildArch(int i,int j) const;
+    static bool WriteFile(const CFileName& name,const std::string& content);
+    static bool MakeDirs(const CFileName& path);
+};
+
+// -----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef AMSBenchOptionsH
+#define AMSBenchOptionsH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <SimpleOptions.hpp>
+#include <AMSMainHeader.hpp>
+
+//------------------------------------------------------------------------------
+
+class CAMSBenchOptions : public CSimpleOptions {
+public:
+    // constructor - tune option setup
+    CAMSBenchOptions(void);
+
+    // program name and description -----------------------------------------------
+    CSO_PROG_NAME_BEGIN
+    "ams-bench"
+    CSO_PROG_NAME_END
+
+    CSO_PROG_DESC_BEGIN
+    "Generate synthetic bundles, host configuration, and software tree and measure "
+    "the module system hot paths. Results are printed as JSON lines, one line per benchmark."
+    CSO_PROG_DESC_END
+
+    CSO_PROG_VERS_BEGIN
+    LibBuildVersion_AMS
+    CSO_PROG_VERS_END
+
+    // list of all options and arguments ------------------------------------------
+    CSO_LIST_BEGIN
+    // options ------------------------------
+    CSO_OPT(int,NumOfModules)
+    CSO_OPT(int,NumOfBuilds)
+    CSO_OPT(int,NumOfTokens)
+    CSO_OPT(int,NumOfBundles)
+    CSO_OPT(int,NumOfRepeats)
+    CSO_OPT(CSmallString,WorkDir)
+    CSO_OPT(CSmallString,Output)
+    CSO_OPT(bool,Keep)
+    CSO_OPT(bool,Help)
+    CSO_OPT(bool,Version)
+    CSO_OPT(bool,Verbose)
+    CSO_LIST_END
+
+    CSO_MAP_BEGIN
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                NumOfModules,                   /* option name */
+                500,                            /* default value */
+                false,                          /* is option mandatory */
+                'n',                            /* short option name */
+                "modules",                      /* long option name */
+                "INT",                          /* parametr name */
+                "number of modules in each bundle")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                NumOfBuilds,                    /* option name */
+                8,                              /* default value */
+                false,                          /* is option mandatory */
+                'm',                            /* short option name */
+                "builds",                       /* long option name */
+                "INT",                          /* parametr name */
+                "number of builds per module")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                NumOfTokens,                    /* option name */
+                6,                              /* default value */
+                false,                          /* is option mandatory */
+                'k',                            /* short option name */
+                "tokens",                       /* long option name */
+                "INT",                          /* parametr name */
+                "number of host architecture tokens")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                NumOfBundles,                   /* option name */
+                2,                              /* default value */
+                false,                          /* is option mandatory */
+                'b',                            /* short option name */
+                "bundles",                      /* long option name */
+                "INT",                          /* parametr name */
+                "number of bundles")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                NumOfRepeats,                   /* option name */
+                10,                             /* default value */
+                false,                          /* is option mandatory */
+                'r',                            /* short option name */
+                "repeat",                       /* long option name */
+                "INT",                          /* parametr name */
+                "number of measured iterations of each benchmark")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                WorkDir,                        /* option name */
+                NULL,                           /* default value */
+                false,                          /* is option mandatory */
+                'w',                            /* short option name */
+                "workdir",                      /* long option name */
+                "PATH",                         /* parametr name */
+                "directory for synthetic data, /tmp/ams-bench.PID by default")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                Output,                         /* option name */
+                "-",                            /* default value */
+                false,                          /* is option mandatory */
+                'o',                            /* short option name */
+                "output",                       /* long option name */
+                "FILE",                         /* parametr name */
+                "write results into the file, - is stdout")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Keep,                           /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                '\0',                           /* short option name */
+                "keep",                         /* long option name */
+                NULL,                           /* parametr name */
+                "keep synthetic data")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Verbose,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'v',                            /* short option name */
+                "verbose",                      /* long option name */
+                NULL,                           /* parametr name */
+                "increase output verbosity")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Version,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                '\0',                           /* short option name */
+                "version",                      /* long option name */
+                NULL,                           /* parametr name */
+                "output version information and exit")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Help,                           /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'h',                            /* short option name */
+                "help",                         /* long option name */
+                NULL,                           /* parametr name */
+                "display this help and exit")   /* option description */
+    CSO_MAP_END
+
+// final operation with options ------------------------------------------------
+private:
+    virtual int CheckOptions(void);
+    virtual int FinalizeOptions(void);
+    virtual int CheckArguments(void);
+};
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -37,6 +37,10 @@
 #include <HostGroup.hpp>
 #include <ModUtils.hpp>
 #include <Module.hpp>
+#include <ActivationCache.hpp>
+#include <StatDatagramQueue.hpp>
+#include <sha1.hpp>
+#include <sys/stat.h>
 
 //------------------------------------------------------------------------------
 
@@ -131,6 +135,16 @@ bool CModuleCmd::Run(void)
 
 // ----------------------------------------------
     if( (Options.GetArgAction() == "add") || (Options.GetArgAction() == "activate") ) {
+        // batch jobs repeat the same activations, try the activation cache first
+        std::list<CSmallString> modules;
+        for(int i=1; i < Options.GetNumberOfProgArgs(); i++) {
+            modules.push_back(Options.GetProgArg(i));
+        }
+        ActivationCache.InitKey(Options.GetArgAction(),modules,Options.GetArgAction() == "activate");
+        if( ActivationCache.ReplayActivation(vout) == true ){
+            return(true);
+        }
+
         ModuleController.LoadBundles(EMBC_SMALL);
         ModuleController.MergeBundles();
         // add modules
@@ -197,7 +211,7 @@ bool CModuleCmd::Run(void)
     }
 // ----------------------------------------------
     else if( Options.GetArgAction() == "help" ) {
-        ModuleController.LoadBundles(EMBC_BIG);
+        ModuleController.LoadBundles(EMBC_SMALL);
         ModuleController.MergeBundles();
         bool ok = true;
         Module.StartHelp();
@@ -245,6 +259,33 @@ bool CModuleCmd::Run(void)
             }
             return(true);
         }
+    // ----------------------------------------------
+        else if( Options.GetArgAction() == "originsmanifest" ) {
+            std::list<CFileName> origins;
+            ModuleController.LoadBundles(EMBC_BIG);
+            ModuleController.MergeBundles();
+            if( Options.GetOptVerbose() == true ) Module.SetPrintLevel(EAPL_VERBOSE);
+            vout << high;
+            // builds shared among the modules are resolved only once
+            for(int i=1; i < Options.GetNumberOfProgArgs(); i++) {
+                Module.AddAllOriginsWithFilters(vout,Options.GetProgArg(i),origins);
+            }
+            vout << low;
+            origins.sort();
+            origins.unique();
+            // manifest: sha1 size path
+            for( CFileName origin : origins ){
+                struct stat info;
+                if( stat(origin,&info) != 0 ){
+                    CSmallString warning;
+                    warning << "origin '" << origin << "' does not exist";
+                    ES_WARNING(warning);
+                    continue;
+                }
+                vout << SHA1::from_file(std::string(origin)) << " " << (long long)info.st_size << " " << origin << endl;
+            }
+            return(true);
+        }
     // ----------------------------------------------
         else if( Options.GetArgAction() == "allmodules" ) {
             ModuleController.LoadBundles(EMBC_SMALL);
@@ -465,12 +506,18 @@ void CModuleCmd::Finalize(void)
     if( (Options.GetArgAction() != "getactmod") &&
         (Options.GetArgAction() != "getactver") &&
         (Options.GetArgAction() != "allorigins") &&
+        (Options.GetArgAction() != "originsmanifest") &&
         (Options.GetArgAction() != "allmodules") &&
         (Options.GetArgAction() != "allbuilds") &&
         (Options.GetArgAction() != "dpkg-deps") ){
         if( ! ForcePrintErrors ) vout << endl;
     }
 
+    // remember successful activation, warnings can indicate incomplete setup
+    if( (ExitCode == 0) && (ErrorSystem.IsAnyRecord() == false) ){
+        ActivationCache.SaveActivation();
+    }
+
     if( (ExitCode != 0) && (ErrorSystem.IsError()) ) {
         ShellProcessor.RollBack();
     }
@@ -481,6 +528,9 @@ void CModuleCmd::Finalize(void)
     if( Options.GetArgAction() != "help" ){
         ShellProcessor.BuildEnvironment();
     }
+
+    // send usage statistics, it must be done before exit
+    StatDatagramQueue.Flush();
 }
 
 //------------------------------------------------------------------------------
@@ -130,6 +130,7 @@ int CModuleCmdOptions::CheckArguments(void)
         if( GetProgArg(0) == "help" ) return(SO_CONTINUE);
         if( GetProgArg(0) == "origin" ) return(SO_CONTINUE);
         if( GetProgArg(0) == "allorigins" ) return(SO_CONTINUE);
+        if( GetProgArg(0) == "originsmanifest" ) return(SO_CONTINUE);
 
         if( (GetProgArg(0) == "getactver") || (GetProgArg(0) == "getactmod") ) {
             if( GetNumberOfProgArgs() != 2 ) {
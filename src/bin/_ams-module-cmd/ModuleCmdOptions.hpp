@@ -75,6 +75,7 @@ public:
     "   <green>getactmod</green>       return name:version if the module is active\n"
     "   <green>getactver</green>       return module version if the module is active\n"
     "   <green>allorigins</green>      show source files for the module/build and all sync dependencies\n"
+    "   <green>originsmanifest</green> print 'sha1 size path' of all origins of the modules/builds\n"
     "   <green>allmodules</green>      list all available modules\n"
     "   <green>allbuilds</green>       list all available builds\n"
     "   <green>dpkg-deps</green>       list system package dependencies\n"
@@ -24,6 +24,7 @@
 #include <ErrorSystem.hpp>
 #include <Shell.hpp>
 #include <ostream>
+#include <vector>
 
 using namespace std;
 
@@ -52,20 +53,18 @@ bool CModuleVar::Run(void)
 {
     CSmallString final_value;
 
+    // the value is removed and then prepended/appended in a single pass
+    std::vector<CSmallString> removed;
+    removed.push_back(Options.GetArgValue());
+
     if( Options.GetArgAction() == "prepend" ) {
-        final_value = CShell::RemoveValue(Options.GetArgVariable(),
-                                          Options.GetArgValue(),
-                                          Options.GetArgDelimiter());
-        final_value = CShell::PrependValue(final_value,
-                                           Options.GetArgValue(),
-                                           Options.GetArgDelimiter());
+        final_value = CShell::EditValueList(Options.GetArgVariable(),removed,
+                                            Options.GetArgValue(),NULL,
+                                            Options.GetArgDelimiter());
     } else if( Options.GetArgAction() == "append" ) {
-        final_value = CShell::RemoveValue(Options.GetArgVariable(),
-                                          Options.GetArgValue(),
-                                          Options.GetArgDelimiter());
-        final_value = CShell::AppendValue(final_value,
-                                          Options.GetArgValue(),
-                                          Options.GetArgDelimiter());
+        final_value = CShell::EditValueList(Options.GetArgVariable(),removed,
+                                            NULL,Options.GetArgValue(),
+                                            Options.GetArgDelimiter());
     } else if( Options.GetArgAction() == "remove" ) {
         final_value = CShell::RemoveValue(Options.GetArgVariable(),
                                           Options.GetArgValue(),
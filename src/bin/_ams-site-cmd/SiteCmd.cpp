@@ -37,6 +37,8 @@
 #include <Module.hpp>
 #include <ModuleController.hpp>
 #include <UserUtils.hpp>
+#include <ActivationCache.hpp>
+#include <StatDatagramQueue.hpp>
 
 //------------------------------------------------------------------------------
 
@@ -328,6 +330,11 @@ void CSiteCmd::Finalize(void)
         if( ! ForcePrintErrors ) vout << endl;
     }
 
+    // remember successful site init, errors of autoloaded modules are not fatal but recorded
+    if( (ExitCode == 0) && (ErrorSystem.IsAnyRecord() == false) ){
+        ActivationCache.SaveActivation();
+    }
+
     if( ErrorSystem.IsError() ) {
         ExitCode = 1;
         ShellProcessor.RollBack();
@@ -335,6 +342,43 @@ void CSiteCmd::Finalize(void)
 
     ShellProcessor.SetExitCode(ExitCode);
     ShellProcessor.BuildEnvironment();
+
+    // send usage statistics, it must be done before exit
+    StatDatagramQueue.Flush();
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CSiteCmd::InitSiteCacheKey(void)
+{
+    // autoloaded and transferred modules
+    std::list<CSmallString> modules;
+    HostGroup.GetHostsConfigAutoLoadedModules(modules);
+    HostGroup.GetHostGroupAutoLoadedModules(modules);
+    AMSRegistry.GetUserAutoLoadedModules(modules);
+    SiteController.GetSSHExportedModules(modules);
+
+    ActivationCache.InitKey("site-init",modules,true);
+
+    // site selection
+    CSmallString site_name = SiteController.GetActiveSite();
+    if( site_name == NULL ) site_name = SiteController.GetBatchJobSite();
+    if( site_name == NULL ) site_name = SiteController.GetSSHSite();
+    if( site_name == NULL ) site_name = HostGroup.GetDefaultSite();
+
+    ActivationCache.AddKeyItem("batchsite",SiteController.GetBatchJobSite());
+    ActivationCache.AddKeyItem("sshsite",SiteController.GetSSHSite());
+    ActivationCache.AddKeyItem("sshpwd",SiteController.GetSSH_PWD());
+    ActivationCache.AddKeyItem("initexecuted",SiteController.WasSiteInitExecuted() ? "Y" : "N");
+    ActivationCache.AddKeyItem("usersoft",AMSRegistry.GetUserBundlePath());
+
+    char origin;
+    ActivationCache.AddKeyItem("umask",CUserUtils::GetUMask(User.GetRequestedUserUMaskMode(origin)));
+
+    // environment blocks and site autoloaded modules, host configs are in the common key
+    ActivationCache.AddFileKeyItem("siteconfig",SiteController.GetSiteConfig(site_name));
 }
 
 //==============================================================================
@@ -609,6 +653,17 @@ int CSiteCmd::InitSite(void)
         return(SITE_STATUS_OK);
     }
 
+// all nodes and all jobs of an array job resolve the same site environment
+    if( SiteController.IsBatchJob() && (SiteController.HasTTY() == false) &&
+        (Options.GetOptForce() == false) ){
+        InitSiteCacheKey();
+        if( ActivationCache.ReplayActivation(vout) == true ){
+            vout << endl;
+            vout << ">>> the site environment was restored from the activation cache" << endl;
+            return(SITE_STATUS_OK);
+        }
+    }
+
 // initialize module subsystems
     vout << high;
     ModuleController.LoadBundles(EMBC_SMALL);
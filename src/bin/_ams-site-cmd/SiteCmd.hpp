@@ -58,6 +58,9 @@ private:
 
     // helper methods
     bool DeactivateSite(const CSmallString& site_name);
+
+    /// init activation cache key for the batch job site init
+    void InitSiteCacheKey(void);
 };
 
 // -----------------------------------------------------------------------------
@@ -31,7 +31,7 @@
 #include <ModBundle.hpp>
 #include <PrintEngine.hpp>
 #include <string.h>
-#include <DirNodeItem.hpp>
+#include <DirTree.hpp>
 
 //------------------------------------------------------------------------------
 
@@ -185,6 +185,7 @@ void CBundleCmd::Finalize(void)
             && (Options.GetArgAction() != "allbuilds")
             && (Options.GetArgAction() != "dpkg-deps")
             && (Options.GetArgAction() != "dirlist")
+            && ! ((Options.GetArgAction() == "index") && (Options.GetProgArg(1) == "export"))
             && (Options.GetOptSilent() == false) ) vout << endl;
 
     vout << high;
@@ -425,6 +426,25 @@ bool CBundleCmd::BundleIndex(void)
             ForcePrintErrors = true;
             return(false);
         }
+    } else if( Options.GetProgArg(1) == "dedup" ){
+        // only the hardlink plan is printed in the silent mode
+        if( Options.GetOptSilent() ) vout << high;
+        if( bundle.ListBuildsForIndex(vout,Options.GetOptPersonal()) == false ){
+            CSmallString error;
+            error << "unable to list build for index";
+            ES_ERROR(error);
+            ForcePrintErrors = true;
+            return(false);
+        }
+        bundle.CalculateDedupReport(vout,! Options.GetOptSilent());
+    } else if( Options.GetProgArg(1) == "export" ){
+        if( bundle.ExportNewIndex("-")  == false ){
+            CSmallString error;
+            error << "unable to export new index";
+            ES_ERROR(error);
+            ForcePrintErrors = true;
+            return(false);
+        }
     } else {
         CSmallString error;
         error << "unsupported index operation '" << Options.GetProgArg(1) << "'";
@@ -616,15 +636,15 @@ bool CBundleCmd::BundleDirList(void)
         return(false);
     }
 
-    CDirNodeItemPtr  dir_tree(new CDirNodeItem);
+    CDirTree  dir_tree;
 
     CFileName root;
     if( Options.GetOptPersonal() ){
         root = bundle.GetFullBundleName();
-        dir_tree->ScanSoftRepoTree(root,4);
+        dir_tree.ScanSoftRepoTree(root,4);
     } else {
         root = bundle.GetBundleRootPath();
-        dir_tree->ScanSoftRepoTree(root,bundle.GetName(),4);
+        dir_tree.ScanSoftRepoTree(root,bundle.GetName(),4);
     }
 
      CXMLElement* p_cele = bundle.GetCacheElement();
@@ -648,7 +668,7 @@ bool CBundleCmd::BundleDirList(void)
              if( package_dir != NULL ){
                  CSmallString build_name;
                  build_name << name << ":" << ver << ":" << arch << ":" << mode;
-                 dir_tree->AddPackageDir(package_dir,build_name);
+                 dir_tree.AddPackageDir(package_dir,build_name);
              }
              p_build = p_build->GetNextSiblingElement("build");
          }
@@ -657,17 +677,17 @@ bool CBundleCmd::BundleDirList(void)
 
     if( Options.GetProgArg(1) == "missing" ){
         // print missing records
-        dir_tree->PrintMissing(vout,root);
+        dir_tree.PrintMissing(vout,root);
     } else if( Options.GetProgArg(1) == "orphans" ){
         // print missing records
-        dir_tree->CountOrphanedChilds();
-        dir_tree->PrintOrphans(vout,root);
+        dir_tree.CountOrphanedChilds();
+        dir_tree.PrintOrphans(vout,root);
     } else if( Options.GetProgArg(1) == "existing" ){
         // print missing records
-        dir_tree->PrintExisting(vout,root);
+        dir_tree.PrintExisting(vout,root);
     } else if( Options.GetProgArg(1) == "all" ){
         // print all records
-        dir_tree->PrintTree(vout,root,0);
+        dir_tree.PrintTree(vout);
     } else {
         CSmallString error;
         error << "unsupported action for dirlist: '" << Options.GetProgArg(1) << "'";
@@ -56,6 +56,8 @@ public:
     "<green>[--personal] index new</green>                               calculate a new index for builds\n"
     "<green>[--silent] [--skipremoved] [--skipadded] index diff</green>  compare new and old indexes\n"
     "<green>index commit</green>                                         commit the new index as an old index\n"
+    "<green>index export</green>                                         print the new index in the text format\n"
+    "<green>[--personal] [--silent] index dedup</green>                  print identical files among builds and a hardlink plan\n"
     "<green>dirname</green>                                              print the full path to the bundle directory\n"
     "<green>rootpath</green>                                             print the full path to the bundle directory root\n"
     "<green>dirlist missing|orphans|existing|all</green>                 bundle softrepo directory tree validator\n"
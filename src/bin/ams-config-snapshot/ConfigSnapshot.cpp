@@ -0,0 +1,170 @@
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include "ConfigSnapshot.hpp"
+#include <ErrorSystem.hpp>
+#include <SmallTimeAndDate.hpp>
+#include <AMSRegistry.hpp>
+#include <AMSConfigSnapshot.hpp>
+#include <FileSystem.hpp>
+#include <Shell.hpp>
+#include <Utils.hpp>
+#include <list>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+MAIN_ENTRY(CConfigSnapshot)
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+int CConfigSnapshot::Init(int argc, char* argv[])
+{
+    // encode program options
+    int result = Options.ParseCmdLine(argc,argv);
+
+    // should we exit or was it error?
+    if( result != SO_CONTINUE ) return(result);
+
+    // attach text console to stdout
+    Console.Attach(stdout);
+
+    // attach verbose stream to terminal stream and set desired verbosity level
+    vout.Attach(Console);
+    if( Options.GetOptVerbose() ) {
+        vout.Verbosity(CVerboseStr::high);
+    } else {
+        vout.Verbosity(CVerboseStr::low);
+    }
+
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-config-snapshot (AMS utility) started at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    vout << low;
+
+    return(SO_CONTINUE);
+}
+
+//------------------------------------------------------------------------------
+
+bool CConfigSnapshot::Run(void)
+{
+    CFileName snapshot_name = Options.GetOptOutput();
+    if( snapshot_name == NULL ){
+        snapshot_name = CAMSConfigSnapshot::GetSnapshotName();
+    }
+
+    if( Options.GetOptInfo() ){
+        if( AMSConfigSnapshot.LoadSnapshot(snapshot_name) == false ) return(false);
+        vout << endl;
+        vout << "# Snapshot: " << snapshot_name << endl;
+        vout << endl;
+        AMSConfigSnapshot.PrintInfo(vout);
+        return(true);
+    }
+
+    // registry drives locations of other files
+    AMSRegistry.LoadRegistry(vout);
+
+    // compile from scratch
+    AMSConfigSnapshot.Clear();
+
+    vout << endl;
+    vout << "# Compiling configuration snapshot ..." << endl;
+
+    // the user registry is private and changed often, only the shared one is included
+    CFileName registry = CShell::GetSystemVariable("AMS_REGISTRY_CONFIG");
+    if( registry != NULL ){
+        if( AddFile(registry) == false ) return(false);
+    }
+
+    if( CFileSystem::IsFile(AMSRegistry.GetHostsConfigFile()) ){
+        if( AddFile(AMSRegistry.GetHostsConfigFile()) == false ) return(false);
+    }
+
+    if( CFileSystem::IsFile(AMSRegistry.GetUsersConfigFile()) ){
+        if( AddFile(AMSRegistry.GetUsersConfigFile()) == false ) return(false);
+    }
+
+    std::list<CFileName> files;
+    CUtils::FindAllFilesInPaths(AMSRegistry.GetHostGroupsSearchPaths(),"*.xml",files);
+    CUtils::FindAllFilesInPaths(AMSRegistry.GetHostSubSystemsSearchPaths(),"*.xml",files);
+    for(CFileName file : files){
+        if( AddFile(file) == false ) return(false);
+    }
+
+    if( AMSConfigSnapshot.SaveSnapshot(snapshot_name) == false ) return(false);
+
+    vout << endl;
+    vout << "# Number of entries : " << AMSConfigSnapshot.GetNumOfEntries() << endl;
+    vout << "# Saved as          : " << snapshot_name << endl;
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CConfigSnapshot::AddFile(const CFileName& name)
+{
+    vout << "  > " << name << endl;
+    if( AMSConfigSnapshot.AddFile(name) == false ){
+        CSmallString error;
+        error << "unable to add '" << name << "' into the snapshot";
+        ES_TRACE_ERROR(error);
+        return(false);
+    }
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+void CConfigSnapshot::Finalize(void)
+{
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-config-snapshot (AMS utility) terminated at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    if( ErrorSystem.IsError() || (ErrorSystem.IsAnyRecord() && Options.GetOptVerbose()) ){
+        vout << low;
+        ErrorSystem.PrintErrors(vout);
+    }
+
+    vout << endl;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
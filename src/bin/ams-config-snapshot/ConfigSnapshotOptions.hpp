@@ -0,0 +1,115 @@
+#ifndef ConfigSnapshotOptionsH
+#define ConfigSnapshotOptionsH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <SimpleOptions.hpp>
+#include <AMSMainHeader.hpp>
+
+//------------------------------------------------------------------------------
+
+class CConfigSnapshotOptions : public CSimpleOptions {
+public:
+    // constructor - tune option setup
+    CConfigSnapshotOptions(void);
+
+    // program name and description -----------------------------------------------
+    CSO_PROG_NAME_BEGIN
+    "ams-config-snapshot"
+    CSO_PROG_NAME_END
+
+    CSO_PROG_DESC_BEGIN
+    "Compile the registry, hosts, host group, host subsystem, and users configuration files "
+    "into the binary snapshot, which is loaded by AMS commands instead of parsing individual XML files. "
+    "Entries of modified files are ignored until the snapshot is compiled again."
+    CSO_PROG_DESC_END
+
+    CSO_PROG_VERS_BEGIN
+    LibBuildVersion_AMS
+    CSO_PROG_VERS_END
+
+    // list of all options and arguments ------------------------------------------
+    CSO_LIST_BEGIN
+    // options ------------------------------
+    CSO_OPT(CSmallString,Output)
+    CSO_OPT(bool,Info)
+    CSO_OPT(bool,Help)
+    CSO_OPT(bool,Version)
+    CSO_OPT(bool,Verbose)
+    CSO_LIST_END
+
+    CSO_MAP_BEGIN
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                Output,                         /* option name */
+                NULL,                           /* default value */
+                false,                          /* is option mandatory */
+                'o',                            /* short option name */
+                "output",                       /* long option name */
+                "FILE",                         /* parametr name */
+                "snapshot file name, AMS_CONFIG_SNAPSHOT or etc/default/config.snapshot by default")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Info,                           /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'i',                            /* short option name */
+                "info",                         /* long option name */
+                NULL,                           /* parametr name */
+                "print entries of the existing snapshot and their status")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Verbose,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'v',                            /* short option name */
+                "verbose",                      /* long option name */
+                NULL,                           /* parametr name */
+                "increase output verbosity")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Version,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                '\0',                           /* short option name */
+                "version",                      /* long option name */
+                NULL,                           /* parametr name */
+                "output version information and exit")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Help,                           /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'h',                            /* short option name */
+                "help",                         /* long option name */
+                NULL,                           /* parametr name */
+                "display this help and exit")   /* option description */
+    CSO_MAP_END
+
+// final operation with options ------------------------------------------------
+private:
+    virtual int CheckOptions(void);
+    virtual int FinalizeOptions(void);
+    virtual int CheckArguments(void);
+};
+
+//------------------------------------------------------------------------------
+
+#endif
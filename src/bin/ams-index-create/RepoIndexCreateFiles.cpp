@@ -131,6 +131,7 @@ bool CRepoIndexCreateFiles::Run(void)
     CFSIndex index;
     index.RootDir = Options.GetArgSourcePath();
     index.PersonalBundle = Options.GetOptIsPersonalBundle();
+    index.CollectFiles = Options.GetOptDedup();
 
     map<CSmallString,CFileName>::iterator it = NewIndex.Paths.begin();
     map<CSmallString,CFileName>::iterator ie = NewIndex.Paths.end();
@@ -156,10 +157,24 @@ bool CRepoIndexCreateFiles::Run(void)
     vout << "# Statistics ..." << endl;
     vout << "  > Number of stat objects  = " << index.NumOfStats << endl;
 
+    if( Options.GetOptDedup() ){
+        index.FindDuplicates();
+        index.PrintDedupReport(vout);
+        vout << endl;
+        vout << "# Hardlink plan (L sha1 size source target) ..." << endl;
+        index.PrintHardlinkPlan(vout);
+    }
+
     vout << endl;
     vout << "# Saving index ..." << endl;
 
-    if( NewIndex.SaveIndex(Options.GetArgIndexName()) == false ){
+    bool result;
+    if( Options.GetOptSnapshot() ){
+        result = NewIndex.SaveSnapshot(Options.GetArgIndexName());
+    } else {
+        result = NewIndex.SaveIndex(Options.GetArgIndexName());
+    }
+    if( result == false ){
         CSmallString error;
         error << "unable to save the index into the '" << Options.GetArgIndexName() << "' file";
         ES_ERROR(error);
@@ -52,6 +52,8 @@ public:
     CSO_ARG(CSmallString,SourceList)
     // options ------------------------------
     CSO_OPT(bool,IsPersonalBundle)
+    CSO_OPT(bool,Snapshot)
+    CSO_OPT(bool,Dedup)
     CSO_OPT(bool,Help)
     CSO_OPT(bool,Version)
     CSO_OPT(bool,Verbose)
@@ -96,6 +98,24 @@ public:
                 NULL,                           /* parametr name */
                 "consider the collection as personal bundle")   /* option description */
     //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Snapshot,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                '\0',                           /* short option name */
+                "snapshot",                      /* long option name */
+                NULL,                           /* parametr name */
+                "save the index as a binary snapshot")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Dedup,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                '\0',                           /* short option name */
+                "dedup",                      /* long option name */
+                NULL,                           /* parametr name */
+                "print identical files among indexed items and a hardlink plan")   /* option description */
+    //----------------------------------------------------------------------
     CSO_MAP_OPT(bool,                           /* option type */
                 Verbose,                        /* option name */
                 false,                          /* default value */
@@ -81,11 +81,11 @@ bool CRepoIndexDiff::Run(void)
     vout << endl;
     vout << "# Loading indexes ..." << endl;
     vout << "  > Old index = " << Options.GetArgOldIndexName() << endl;
-    if( OldIndex.LoadIndex(Options.GetArgOldIndexName()) == false ){
+    if( OldIndex.OpenIndex(Options.GetArgOldIndexName()) == false ){
         return(false);
     }
     vout << "  > New index = " << Options.GetArgNewIndexName() << endl;
-    if( NewIndex.LoadIndex(Options.GetArgNewIndexName()) == false ){
+    if( NewIndex.OpenIndex(Options.GetArgNewIndexName()) == false ){
         return(false);
     }
 
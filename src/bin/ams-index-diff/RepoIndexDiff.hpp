@@ -47,8 +47,8 @@ private:
     CRepoIndexDiffOptions   Options;
     CTerminalStr            Console;
     CVerboseStr             vout;
-    CModBundleIndex         NewIndex;
-    CModBundleIndex         OldIndex;
+    CModBundleIndexSnapshot NewIndex;
+    CModBundleIndexSnapshot OldIndex;
 };
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,467 @@
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <AMSConfigSnapshot.hpp>
+#include <AMSRegistry.hpp>
+#include <AMSProfiler.hpp>
+#include <ErrorSystem.hpp>
+#include <Shell.hpp>
+#include <XMLDocument.hpp>
+#include <XMLElement.hpp>
+#include <XMLText.hpp>
+#include <XMLAttribute.hpp>
+#include <XMLParser.hpp>
+#include <fstream>
+#include <iomanip>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+CAMSConfigSnapshot AMSConfigSnapshot;
+
+//------------------------------------------------------------------------------
+
+// increase on any change of the format
+#define AMS_SNAPSHOT_MAGIC      "AMSCSNAP"
+#define AMS_SNAPSHOT_VERSION    1
+#define AMS_SNAPSHOT_BYTE_ORDER 0x01020304
+
+// node tags
+#define AMS_SNAPSHOT_ELEMENT    'E'
+#define AMS_SNAPSHOT_TEXT       'T'
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CAMSConfigSnapshot::CAMSConfigSnapshot(void)
+{
+    Initialized = false;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+const CFileName CAMSConfigSnapshot::GetSnapshotName(void)
+{
+    CFileName name = CShell::GetSystemVariable("AMS_CONFIG_SNAPSHOT");
+    if( name == NULL ){
+        name = AMSRegistry.GetETCDIR() / "default" / "config.snapshot";
+    }
+    return(name);
+}
+
+//------------------------------------------------------------------------------
+
+int CAMSConfigSnapshot::GetNumOfEntries(void) const
+{
+    return(Entries.size());
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSConfigSnapshot::InitSnapshot(void)
+{
+    if( Initialized ) return;
+    Initialized = true;
+
+    CFileName name = GetSnapshotName();
+    if( name == "none" ) return;
+
+    // the snapshot is optional
+    struct stat info;
+    if( stat(name,&info) != 0 ) return;
+
+    if( LoadSnapshot(name) == false ){
+        ErrorSystem.RemoveAllErrors(); // avoid global error
+        CSmallString warning;
+        warning << "unable to load config snapshot '" << name << "', XML files will be parsed";
+        ES_WARNING(warning);
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CAMSConfigSnapshot::LoadXMLFile(const CFileName& name,CXMLNode* p_doc)
+{
+    if( p_doc == NULL ){
+        RUNTIME_ERROR("p_doc is NULL");
+    }
+
+    InitSnapshot();
+
+    std::map<std::string,SEntry>::iterator it = Entries.find(string(name));
+    if( (it != Entries.end()) && IsEntryUpToDate(it->first,it->second) ){
+        const char* p_data = Data.data() + it->second.Offset;
+        const char* p_end  = p_data + it->second.Length;
+        if( ReadNodes(p_data,p_end,p_doc) && (p_data == p_end) ){
+            return(true);
+        }
+        // damaged entry - parse the file
+        p_doc->RemoveAllChildNodes();
+    }
+
+    CXMLParser xml_parser;
+    xml_parser.SetOutputXMLNode(p_doc);
+    return(xml_parser.Parse(name));
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSConfigSnapshot::IsEntryUpToDate(const std::string& name,const SEntry& entry)
+{
+    struct stat info;
+    if( stat(name.c_str(),&info) != 0 ) return(false);
+
+    return( (info.st_mtim.tv_sec == entry.MTimeSec) && (info.st_mtim.tv_nsec == entry.MTimeNSec) &&
+            (info.st_size == entry.Size) );
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CAMSConfigSnapshot::LoadSnapshot(const CFileName& name)
+{
+    CAMSProfilerPhase phase("config-snapshot-load");
+
+    Data.clear();
+    Entries.clear();
+
+    // one read
+    ifstream ifs(name,ios::in | ios::binary);
+    if( ! ifs ){
+        CSmallString error;
+        error << "unable to open config snapshot '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+    ifs.seekg(0,ios::end);
+    streamoff size = ifs.tellg();
+    ifs.seekg(0,ios::beg);
+    if( size <= 0 ){
+        ES_ERROR("empty config snapshot");
+        return(false);
+    }
+    Data.resize(size);
+    ifs.read(&Data[0],size);
+    if( ! ifs ){
+        Data.clear();
+        CSmallString error;
+        error << "unable to read config snapshot '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    // header
+    const char* p_data = Data.data();
+    const char* p_end  = p_data + Data.size();
+
+    size_t magic_len = strlen(AMS_SNAPSHOT_MAGIC);
+    if( (Data.size() < magic_len) || (strncmp(p_data,AMS_SNAPSHOT_MAGIC,magic_len) != 0) ){
+        Data.clear();
+        ES_ERROR("not a config snapshot");
+        return(false);
+    }
+    p_data += magic_len;
+
+    uint32_t version = 0, byte_order = 0, num_of_entries = 0;
+    bool result = true;
+    result &= ReadUInt32(p_data,p_end,version);
+    result &= ReadUInt32(p_data,p_end,byte_order);
+    result &= ReadUInt32(p_data,p_end,num_of_entries);
+    if( (result == false) || (version != AMS_SNAPSHOT_VERSION) || (byte_order != AMS_SNAPSHOT_BYTE_ORDER) ){
+        Data.clear();
+        ES_ERROR("unsupported version or byte order of config snapshot");
+        return(false);
+    }
+
+    // index of entries
+    for(uint32_t i=0; i < num_of_entries; i++){
+        string  file_name;
+        SEntry  entry;
+        uint32_t length = 0;
+        result &= ReadString(p_data,p_end,file_name);
+        result &= ReadInt64(p_data,p_end,entry.MTimeSec);
+        result &= ReadInt64(p_data,p_end,entry.MTimeNSec);
+        result &= ReadInt64(p_data,p_end,entry.Size);
+        result &= ReadUInt32(p_data,p_end,length);
+        if( (result == false) || ((size_t)(p_end - p_data) < length) ){
+            Data.clear();
+            Entries.clear();
+            ES_ERROR("config snapshot is truncated");
+            return(false);
+        }
+        entry.Offset = p_data - Data.data();
+        entry.Length = length;
+        Entries[file_name] = entry;
+        p_data += length;
+    }
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CAMSConfigSnapshot::Clear(void)
+{
+    Initialized = true;
+    Data.clear();
+    Entries.clear();
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSConfigSnapshot::AddFile(const CFileName& name)
+{
+    // stat before parsing - modification during the compilation invalidates the entry
+    struct stat info;
+    if( stat(name,&info) != 0 ){
+        CSmallString error;
+        error << "unable to stat file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    CXMLDocument xml_doc;
+    CXMLParser   xml_parser;
+    xml_parser.SetOutputXMLNode(&xml_doc);
+    if( xml_parser.Parse(name) == false ){
+        CSmallString error;
+        error << "unable to parse file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    SEntry entry;
+    entry.MTimeSec  = info.st_mtim.tv_sec;
+    entry.MTimeNSec = info.st_mtim.tv_nsec;
+    entry.Size      = info.st_size;
+    entry.Offset    = Data.size();
+    WriteNodes(Data,&xml_doc);
+    entry.Length    = Data.size() - entry.Offset;
+
+    Entries[string(name)] = entry;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSConfigSnapshot::SaveSnapshot(const CFileName& name)
+{
+    string out;
+    out.append(AMS_SNAPSHOT_MAGIC);
+    WriteUInt32(out,AMS_SNAPSHOT_VERSION);
+    WriteUInt32(out,AMS_SNAPSHOT_BYTE_ORDER);
+    WriteUInt32(out,Entries.size());
+
+    for(const std::pair<const std::string,SEntry>& item : Entries){
+        WriteString(out,item.first.c_str());
+        WriteInt64(out,item.second.MTimeSec);
+        WriteInt64(out,item.second.MTimeNSec);
+        WriteInt64(out,item.second.Size);
+        WriteUInt32(out,item.second.Length);
+        out.append(Data,item.second.Offset,item.second.Length);
+    }
+
+    // readers must never see a partially written snapshot
+    CFileName tmp_name = name + ".tmp";
+    ofstream ofs(tmp_name,ios::out | ios::binary | ios::trunc);
+    ofs.write(out.data(),out.size());
+    ofs.close();
+    if( ! ofs ){
+        CSmallString error;
+        error << "unable to write config snapshot '" << tmp_name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    if( rename(tmp_name,name) != 0 ){
+        CSmallString error;
+        error << "unable to rename '" << tmp_name << "' to '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CAMSConfigSnapshot::PrintInfo(CVerboseStr& vout)
+{
+    vout << "# Status   Size     File" << endl;
+    vout << "# -------- -------- -------------------------------------------------------------" << endl;
+
+    for(const std::pair<const std::string,SEntry>& item : Entries){
+        if( IsEntryUpToDate(item.first,item.second) ){
+            vout << "  <green>valid</green>    ";
+        } else {
+            vout << "  <red>outdated</red> ";
+        }
+        vout << right << setw(8) << item.second.Length << left << " " << item.first << endl;
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CAMSConfigSnapshot::WriteNodes(std::string& out,CXMLNode* p_parent)
+{
+    uint32_t count = 0;
+    CXMLNode* p_node = p_parent->GetFirstChildNode();
+    while( p_node != NULL ){
+        if( (p_node->GetNodeType() == EXNT_ELEMENT) || (p_node->GetNodeType() == EXNT_TEXT) ) count++;
+        p_node = p_node->GetNextSiblingNode();
+    }
+    WriteUInt32(out,count);
+
+    p_node = p_parent->GetFirstChildNode();
+    while( p_node != NULL ){
+        if( p_node->GetNodeType() == EXNT_ELEMENT ){
+            CXMLElement* p_ele = static_cast<CXMLElement*>(p_node);
+            out.push_back(AMS_SNAPSHOT_ELEMENT);
+            WriteString(out,p_ele->GetName());
+            WriteUInt32(out,p_ele->NumOfAttributes());
+            CXMLAttribute* p_attr = p_ele->GetFirstAttribute();
+            while( p_attr != NULL ){
+                WriteString(out,p_attr->Name);
+                WriteString(out,p_attr->Value);
+                p_attr = p_attr->GetNextSiblingAttribute();
+            }
+            WriteNodes(out,p_ele);
+        }
+        if( p_node->GetNodeType() == EXNT_TEXT ){
+            CXMLText* p_text = static_cast<CXMLText*>(p_node);
+            out.push_back(AMS_SNAPSHOT_TEXT);
+            WriteString(out,p_text->GetText());
+        }
+        p_node = p_node->GetNextSiblingNode();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSConfigSnapshot::ReadNodes(const char*& p_data,const char* p_end,CXMLNode* p_parent)
+{
+    uint32_t count = 0;
+    if( ReadUInt32(p_data,p_end,count) == false ) return(false);
+
+    for(uint32_t i=0; i < count; i++){
+        if( p_data >= p_end ) return(false);
+        char tag = *p_data++;
+        if( tag == AMS_SNAPSHOT_ELEMENT ){
+            string   name;
+            uint32_t num_of_attrs = 0;
+            if( ReadString(p_data,p_end,name) == false ) return(false);
+            if( ReadUInt32(p_data,p_end,num_of_attrs) == false ) return(false);
+            CXMLElement* p_ele = p_parent->CreateChildElement(name.c_str());
+            for(uint32_t j=0; j < num_of_attrs; j++){
+                string aname, avalue;
+                if( ReadString(p_data,p_end,aname) == false ) return(false);
+                if( ReadString(p_data,p_end,avalue) == false ) return(false);
+                p_ele->SetAttribute(aname.c_str(),CSmallString(avalue.c_str()));
+            }
+            if( ReadNodes(p_data,p_end,p_ele) == false ) return(false);
+        } else if( tag == AMS_SNAPSHOT_TEXT ){
+            string text;
+            if( ReadString(p_data,p_end,text) == false ) return(false);
+            p_parent->CreateChildText(text.c_str());
+        } else {
+            return(false);
+        }
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSConfigSnapshot::WriteUInt32(std::string& out,uint32_t value)
+{
+    out.append((const char*)&value,sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSConfigSnapshot::WriteInt64(std::string& out,int64_t value)
+{
+    out.append((const char*)&value,sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSConfigSnapshot::WriteString(std::string& out,const char* p_str)
+{
+    uint32_t len = 0;
+    if( p_str != NULL ) len = strlen(p_str);
+    WriteUInt32(out,len);
+    if( len > 0 ) out.append(p_str,len);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSConfigSnapshot::ReadUInt32(const char*& p_data,const char* p_end,uint32_t& value)
+{
+    if( (size_t)(p_end - p_data) < sizeof(value) ) return(false);
+    memcpy(&value,p_data,sizeof(value));
+    p_data += sizeof(value);
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSConfigSnapshot::ReadInt64(const char*& p_data,const char* p_end,int64_t& value)
+{
+    if( (size_t)(p_end - p_data) < sizeof(value) ) return(false);
+    memcpy(&value,p_data,sizeof(value));
+    p_data += sizeof(value);
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAMSConfigSnapshot::ReadString(const char*& p_data,const char* p_end,std::string& value)
+{
+    uint32_t len = 0;
+    if( ReadUInt32(p_data,p_end,len) == false ) return(false);
+    if( (size_t)(p_end - p_data) < len ) return(false);
+    value.assign(p_data,len);
+    p_data += len;
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
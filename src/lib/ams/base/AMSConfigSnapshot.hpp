@@ -0,0 +1,115 @@
+#ifndef AMSConfigSnapshotH
+#define AMSConfigSnapshotH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <FileName.hpp>
+#include <VerboseStr.hpp>
+#include <string>
+#include <map>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+
+class CXMLNode;
+
+// -----------------------------------------------------------------------------
+
+/// binary snapshot of configuration XML files (registry, hosts config,
+/// host groups, host subsystems, users config)
+/// the snapshot is compiled by ams-config-snapshot, each entry is valid only
+/// if mtime and size of the source file are unchanged
+/// the snapshot is in the native byte order, it is not portable among architectures
+
+class AMS_PACKAGE CAMSConfigSnapshot {
+public:
+// constructor -----------------------------------------------------------------
+    CAMSConfigSnapshot(void);
+
+// input methods ---------------------------------------------------------------
+    /// load XML file from the snapshot if it is up-to-date, otherwise parse it
+    bool LoadXMLFile(const CFileName& name,CXMLNode* p_doc);
+
+    /// load snapshot
+    bool LoadSnapshot(const CFileName& name);
+
+// compilation -----------------------------------------------------------------
+    /// parse XML file and add it into the snapshot
+    bool AddFile(const CFileName& name);
+
+    /// remove all entries
+    void Clear(void);
+
+    /// save snapshot
+    bool SaveSnapshot(const CFileName& name);
+
+// information methods ---------------------------------------------------------
+    /// get snapshot name - AMS_CONFIG_SNAPSHOT or etc/default/config.snapshot
+    static const CFileName GetSnapshotName(void);
+
+    /// print snapshot entries and their status
+    void PrintInfo(CVerboseStr& vout);
+
+    /// number of entries
+    int GetNumOfEntries(void) const;
+
+// section of private data -----------------------------------------------------
+private:
+    struct SEntry {
+        int64_t     MTimeSec;
+        int64_t     MTimeNSec;
+        int64_t     Size;
+        size_t      Offset;     // offset into Data
+        size_t      Length;
+    };
+
+    bool                            Initialized;
+    std::string                     Data;
+    std::map<std::string,SEntry>    Entries;
+
+    /// load default snapshot on the first use
+    void InitSnapshot(void);
+
+    /// is entry still valid?
+    static bool IsEntryUpToDate(const std::string& name,const SEntry& entry);
+
+    /// serialize child nodes (elements and texts)
+    static void WriteNodes(std::string& out,CXMLNode* p_parent);
+
+    /// deserialize child nodes
+    static bool ReadNodes(const char*& p_data,const char* p_end,CXMLNode* p_parent);
+
+    // helpers
+    static void WriteUInt32(std::string& out,uint32_t value);
+    static void WriteInt64(std::string& out,int64_t value);
+    static void WriteString(std::string& out,const char* p_str);
+    static bool ReadUInt32(const char*& p_data,const char* p_end,uint32_t& value);
+    static bool ReadInt64(const char*& p_data,const char* p_end,int64_t& value);
+    static bool ReadString(const char*& p_data,const char* p_end,std::string& value);
+};
+
+// -----------------------------------------------------------------------------
+
+extern AMS_PACKAGE CAMSConfigSnapshot AMSConfigSnapshot;
+
+// -----------------------------------------------------------------------------
+
+#endif
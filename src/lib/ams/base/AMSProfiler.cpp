@@ -0,0 +1,275 @@
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <AMSProfiler.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <malloc.h>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+CAMSProfiler AMSProfiler;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CAMSProfiler::CAMSProfiler(void)
+{
+    Enabled = false;
+    Finalized = false;
+    Level = 0;
+
+    const char* p_profile = getenv("AMS_PROFILE");
+    if( (p_profile == NULL) || (strlen(p_profile) == 0) || (strcmp(p_profile,"0") == 0) ) return;
+
+    Enabled = true;
+    if( strcmp(p_profile,"1") != 0 ){
+        TraceFile = p_profile;
+    }
+
+    Phases.reserve(64);
+    GetSample(Start);
+}
+
+//------------------------------------------------------------------------------
+
+CAMSProfiler::~CAMSProfiler(void)
+{
+    Finalize();
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CAMSProfiler::IsEnabled(void) const
+{
+    return(Enabled);
+}
+
+//------------------------------------------------------------------------------
+
+int CAMSProfiler::BeginPhase(const char* name)
+{
+    if( (Enabled == false) || Finalized ) return(-1);
+
+    SPhase phase;
+    phase.Name  = name;
+    phase.Level = Level++;
+    GetSample(phase.Begin);
+    phase.End = phase.Begin;
+    Phases.push_back(phase);
+
+    return(Phases.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSProfiler::EndPhase(int id)
+{
+    if( (id < 0) || ((size_t)id >= Phases.size()) ) return;
+    GetSample(Phases[id].End);
+    Level--;
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSProfiler::IncCounter(const std::string& name)
+{
+    if( (Enabled == false) || Finalized ) return;
+    Counters[name]++;
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSProfiler::Finalize(void)
+{
+    if( (Enabled == false) || Finalized ) return;
+    Finalized = true;
+
+    if( TraceFile == NULL ){
+        PrintSummary();
+    } else {
+        WriteTrace();
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CAMSProfiler::GetSample(SSample& sample)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    sample.Wall = ts.tv_sec*1e6 + ts.tv_nsec*1e-3;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF,&usage);
+    sample.CPU =   (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)*1e6
+                 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+
+    // the allocator is not replaced, the heap usage is sampled from malloc
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+    struct mallinfo2 minfo = mallinfo2();
+#else
+    struct mallinfo minfo = mallinfo();
+#endif
+    sample.Heap = minfo.uordblks + minfo.hblkhd;
+
+    // per-process I/O accounting, the probe itself is one read syscall
+    sample.RWCalls = 0;
+    int fd = open("/proc/self/io",O_RDONLY);
+    if( fd < 0 ) return;
+    char buffer[512];
+    ssize_t len = read(fd,buffer,sizeof(buffer)-1);
+    close(fd);
+    if( len <= 0 ) return;
+    buffer[len] = '\0';
+
+    const char* p_syscr = strstr(buffer,"syscr:");
+    const char* p_syscw = strstr(buffer,"syscw:");
+    if( p_syscr ) sample.RWCalls += strtoul(p_syscr+6,NULL,10);
+    if( p_syscw ) sample.RWCalls += strtoul(p_syscw+6,NULL,10);
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSProfiler::PrintSummary(void)
+{
+    SSample end;
+    GetSample(end);
+
+    fprintf(stderr,"\n");
+    fprintf(stderr,"# AMS profile: %s (pid %d)\n",program_invocation_short_name,getpid());
+    fprintf(stderr,"# %-36s %10s %10s %10s %10s\n","phase","wall[ms]","cpu[ms]","heap[kB]","rw-calls");
+    fprintf(stderr,"# ------------------------------------ ---------- ---------- ---------- ----------\n");
+
+    for(const SPhase& phase : Phases){
+        char name[256];
+        snprintf(name,sizeof(name),"%*s%s",2*phase.Level,"",phase.Name);
+        fprintf(stderr,"  %-36s %10.3f %10.3f %10ld %10lu\n",name,
+                (phase.End.Wall - phase.Begin.Wall)*1e-3,
+                (phase.End.CPU - phase.Begin.CPU)*1e-3,
+                (phase.End.Heap - phase.Begin.Heap)/1024,
+                phase.End.RWCalls - phase.Begin.RWCalls);
+    }
+
+    fprintf(stderr,"# ------------------------------------ ---------- ---------- ---------- ----------\n");
+    fprintf(stderr,"  %-36s %10.3f %10.3f %10ld %10lu\n","total (since library load)",
+            (end.Wall - Start.Wall)*1e-3,
+            (end.CPU - Start.CPU)*1e-3,
+            (end.Heap - Start.Heap)/1024,
+            end.RWCalls - Start.RWCalls);
+
+    if( Counters.empty() ) return;
+
+    fprintf(stderr,"\n");
+    fprintf(stderr,"# %-58s %10s\n","counter","count");
+    fprintf(stderr,"# ---------------------------------------------------------- ----------\n");
+    for(const auto& counter : Counters){
+        fprintf(stderr,"  %-58s %10lu\n",counter.first.c_str(),counter.second);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CAMSProfiler::WriteTrace(void)
+{
+    SSample end;
+    GetSample(end);
+
+    int pid = getpid();
+
+    // several commands are usually executed in a row - %p is replaced by process id
+    std::string name(TraceFile);
+    size_t pos = name.find("%p");
+    if( pos != std::string::npos ){
+        char spid[32];
+        snprintf(spid,sizeof(spid),"%d",pid);
+        name.replace(pos,2,spid);
+    }
+
+    FILE* p_fout = fopen(name.c_str(),"w");
+    if( p_fout == NULL ){
+        fprintf(stderr,"AMS_PROFILE: unable to open trace file '%s' (%s)\n",
+                name.c_str(),strerror(errno));
+        return;
+    }
+
+    fprintf(p_fout,"{\"traceEvents\":[\n");
+    fprintf(p_fout,"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+            pid,program_invocation_short_name);
+    fprintf(p_fout,"{\"name\":\"total\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                   "\"args\":{\"cpu_us\":%.0f,\"heap_kb\":%ld,\"rw_syscalls\":%lu}}",
+            pid,pid,Start.Wall,end.Wall - Start.Wall,end.CPU - Start.CPU,
+            (end.Heap - Start.Heap)/1024,end.RWCalls - Start.RWCalls);
+
+    for(const SPhase& phase : Phases){
+        fprintf(p_fout,",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                       "\"args\":{\"cpu_us\":%.0f,\"heap_kb\":%ld,\"rw_syscalls\":%lu}}",
+                phase.Name,pid,pid,phase.Begin.Wall,phase.End.Wall - phase.Begin.Wall,
+                phase.End.CPU - phase.Begin.CPU,
+                (phase.End.Heap - phase.Begin.Heap)/1024,
+                phase.End.RWCalls - phase.Begin.RWCalls);
+    }
+
+    if( Counters.empty() == false ){
+        fprintf(p_fout,",\n{\"name\":\"counters\",\"ph\":\"C\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"args\":{",
+                pid,pid,end.Wall);
+        bool first = true;
+        for(const auto& counter : Counters){
+            fprintf(p_fout,"%s\"%s\":%lu",first ? "" : ",",counter.first.c_str(),counter.second);
+            first = false;
+        }
+        fprintf(p_fout,"}}");
+    }
+
+    fprintf(p_fout,"\n]}\n");
+    fclose(p_fout);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CAMSProfilerPhase::CAMSProfilerPhase(const char* name)
+{
+    ID = AMSProfiler.BeginPhase(name);
+}
+
+//------------------------------------------------------------------------------
+
+CAMSProfilerPhase::~CAMSProfilerPhase(void)
+{
+    AMSProfiler.EndPhase(ID);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
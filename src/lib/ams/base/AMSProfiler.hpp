@@ -0,0 +1,110 @@
+#ifndef AMSProfilerH
+#define AMSProfilerH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <FileName.hpp>
+#include <vector>
+#include <string>
+#include <map>
+
+// -----------------------------------------------------------------------------
+
+/// startup profiler - enabled by AMS_PROFILE environment variable
+///   AMS_PROFILE=1          - print phase summary to stderr at exit
+///   AMS_PROFILE=file.json  - write phases in Chrome trace format into file
+///                            %p in the file name is replaced by process id
+/// rw-calls are read/write syscalls from /proc/self/io, stat/open/readdir are not counted
+class AMS_PACKAGE CAMSProfiler {
+public:
+// constructor and destructors -------------------------------------------------
+    CAMSProfiler(void);
+    ~CAMSProfiler(void);
+
+// executive methods -----------------------------------------------------------
+    /// is profiling enabled?
+    bool IsEnabled(void) const;
+
+    /// begin phase, name must be a string literal, returns phase id or -1
+    int BeginPhase(const char* name);
+
+    /// end phase
+    void EndPhase(int id);
+
+    /// increment named counter (e.g. lookups per key)
+    void IncCounter(const std::string& name);
+
+    /// print or write collected data, called automatically at exit
+    void Finalize(void);
+
+// section of private data -----------------------------------------------------
+private:
+    struct SSample {
+        double          Wall;       // in microseconds
+        double          CPU;        // in microseconds, user + system
+        long            Heap;       // allocated heap in bytes (mallinfo)
+        unsigned long   RWCalls;    // number of read and write syscalls (syscr + syscw)
+    };
+
+    struct SPhase {
+        const char*     Name;
+        int             Level;
+        SSample         Begin;
+        SSample         End;
+    };
+
+    bool                Enabled;
+    bool                Finalized;
+    CFileName           TraceFile;      // empty - print to stderr
+    SSample             Start;
+    int                 Level;
+    std::vector<SPhase> Phases;
+    std::map<std::string,unsigned long> Counters;
+
+    /// take a sample of counters
+    static void GetSample(SSample& sample);
+
+    /// print summary to stderr
+    void PrintSummary(void);
+
+    /// write Chrome trace file
+    void WriteTrace(void);
+};
+
+// -----------------------------------------------------------------------------
+
+/// scoped phase
+class AMS_PACKAGE CAMSProfilerPhase {
+public:
+    CAMSProfilerPhase(const char* name);
+    ~CAMSProfilerPhase(void);
+
+private:
+    int ID;
+};
+
+// -----------------------------------------------------------------------------
+
+extern AMS_PACKAGE CAMSProfiler AMSProfiler;
+
+// -----------------------------------------------------------------------------
+
+#endif
@@ -36,6 +36,8 @@
 #include <UserUtils.hpp>
 #include <SiteController.hpp>
 #include <TerminalStr.hpp>
+#include <AMSProfiler.hpp>
+#include <AMSConfigSnapshot.hpp>
 
 //------------------------------------------------------------------------------
 
@@ -65,6 +67,8 @@ CAMSRegistry::CAMSRegistry(void)
 
 void CAMSRegistry::LoadRegistry(CVerboseStr& vout)
 {
+    CAMSProfilerPhase phase("registry-load");
+
     if( ConfigLoaded ) return;
 
 // load config
@@ -79,9 +83,7 @@ void CAMSRegistry::LoadRegistry(CVerboseStr& vout)
         return;
     }
 
-    CXMLParser xml_parser;
-    xml_parser.SetOutputXMLNode(&Config);
-    if( xml_parser.Parse(config_name) == false ){
+    if( AMSConfigSnapshot.LoadXMLFile(config_name,&Config) == false ){
         ErrorSystem.RemoveAllErrors(); // avoid global error
         CSmallString warning;
         warning << "unable to parse user-registry file '" << config_name << "'";
@@ -89,11 +91,31 @@ void CAMSRegistry::LoadRegistry(CVerboseStr& vout)
         return;
     }
 
+    IndexVariables();
+
     ConfigLoaded = true;
 }
 
 //------------------------------------------------------------------------------
 
+void CAMSRegistry::IndexVariables(void)
+{
+    Variables.clear();
+
+    CXMLElement* p_ele = Config.GetChildElementByPath("registry/ams/variables/variable");
+
+    while( p_ele != NULL ){
+        CSmallString vname,value;
+        p_ele->GetAttribute("name",vname);
+        p_ele->GetAttribute("value",value);
+        // the first record wins as in the former sequential lookup
+        Variables.emplace(std::string(vname),std::string(value));
+        p_ele = p_ele->GetNextSiblingElement("variable");
+    }
+}
+
+//------------------------------------------------------------------------------
+
 bool CAMSRegistry::SaveUserConfig(void)
 {
     CVerboseStr fake;
@@ -129,6 +151,7 @@ bool CAMSRegistry::SaveRegistry(const CFileName& registry_name)
     SetRegistryVariable("AMS_PRINT_PROFILE_PATH");
     SetRegistryVariable("AMS_BUNDLE_NAME");
     SetRegistryVariable("AMS_BUNDLE_PATH");
+    IndexVariables();
 
     CXMLPrinter xml_printer;
     xml_printer.SetPrintedXMLNode(&Config);
@@ -146,19 +169,14 @@ bool CAMSRegistry::SaveRegistry(const CFileName& registry_name)
 
 const CSmallString CAMSRegistry::GetSystemVariable(const CSmallString& name)
 {
-// first try registry records
-    CXMLElement* p_ele = Config.GetChildElementByPath("registry/ams/variables/variable");
-
-    while( p_ele != NULL ){
-        CSmallString vname,value;
-        p_ele->GetAttribute("name",vname);
-        p_ele->GetAttribute("value",value);
-
-        if( vname == name ){
-            return(value);
-        }
+    if( AMSProfiler.IsEnabled() ){
+        AMSProfiler.IncCounter(std::string("registry:") + (const char*)name);
+    }
 
-        p_ele = p_ele->GetNextSiblingElement("variable");
+// first try registry records
+    auto it = Variables.find(std::string(name));
+    if( it != Variables.end() ){
+        return(it->second.c_str());
     }
 
 // then try system ones
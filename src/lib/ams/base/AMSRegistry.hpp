@@ -28,6 +28,8 @@
 #include <FileName.hpp>
 #include <AmsUUID.hpp>
 #include <list>
+#include <string>
+#include <unordered_map>
 #include <VerboseStr.hpp>
 
 //------------------------------------------------------------------------------
@@ -174,6 +176,10 @@ private:
     CFileName       AMSRoot;            // ams root directory - read from AMS_ROOT_V9 variable
     CXMLDocument    Config;             // global config data
     bool            ConfigLoaded;
+    std::unordered_map<std::string,std::string> Variables;  // registry variables indexed by name
+
+    /// index registry variables
+    void IndexVariables(void);
 
     /// get user global setup
     const CFileName GetUserGlobalConfig(CVerboseStr& vout);
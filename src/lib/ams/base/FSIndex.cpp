@@ -27,6 +27,10 @@
 #include <vector>
 #include <list>
 #include <sstream>
+#include <fstream>
+#include <set>
+#include <tuple>
+#include <thread>
 #include <sha1.hpp>
 #include <FileSystem.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -47,7 +51,15 @@ CFSIndex::CFSIndex(void)
 {
     PersonalBundle  = false;
     IncludeParents  = true;
+    CollectFiles    = false;
     NumOfStats      = 0;
+
+    CurrentBuild            = -1;
+    NumOfHashedFiles        = 0;
+    NumOfRedundantFiles     = 0;
+    NumOfLinkedFiles        = 0;
+    NumOfCrossBuildGroups   = 0;
+    RedundantSize           = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -105,6 +117,7 @@ std::string CFSIndex::CalculateBuildHash(const CFileName& build_path)
     }
 
     // scan the build directory
+    RegisterBuild(full_path);
     HashDir(full_path,sha1);
 
     // final hash
@@ -140,6 +153,7 @@ std::string CFSIndex::CalculateDirHash(const CFileName& dir_path)
     // DEBUG: cout << full_path << endl;
 
     // scan the build directory
+    RegisterBuild(full_path);
     HashDir(full_path,sha1);
 
     // final hash
@@ -209,6 +223,19 @@ void CFSIndex::HashDir(const CFileName& full_path,SHA1& sha1)
 
         if (S_ISLNK(my_stat.st_mode)) continue;
 
+        if( CollectFiles && (CurrentBuild >= 0) && S_ISREG(my_stat.st_mode) ){
+            SFileEntry entry;
+            entry.Path  = sub_node;
+            entry.Dev   = my_stat.st_dev;
+            entry.Ino   = my_stat.st_ino;
+            entry.Size  = my_stat.st_size;
+            entry.Mode  = my_stat.st_mode;
+            entry.UID   = my_stat.st_uid;
+            entry.GID   = my_stat.st_gid;
+            entry.Build = CurrentBuild;
+            Files.push_back(entry);
+        }
+
         if (S_ISDIR(my_stat.st_mode)) {
             HashDir(sub_node,sha1);
         }
@@ -251,4 +278,160 @@ void CFSIndex::HashNode(const CFileName& name,struct stat& my_stat,bool build_no
 //------------------------------------------------------------------------------
 //==============================================================================
 
+void CFSIndex::RegisterBuild(const CFileName& full_path)
+{
+    if( CollectFiles == false ) return;
+    CurrentBuild = Builds.size();
+    Builds.push_back(full_path);
+}
+
+//------------------------------------------------------------------------------
+
+std::string CFSIndex::CalculateContentHash(const CFileName& full_path)
+{
+    ifstream ifs(full_path,ios::in | ios::binary);
+    if( ! ifs ) return("");
+    SHA1 sha1;
+    sha1.update(ifs);
+    return( sha1.final() );
+}
+
+//------------------------------------------------------------------------------
+
+void CFSIndex::FindDuplicates(int nthreads)
+{
+    Duplicates.clear();
+    NumOfRedundantFiles     = 0;
+    NumOfLinkedFiles        = 0;
+    NumOfCrossBuildGroups   = 0;
+    RedundantSize           = 0;
+
+    // only files with the same size, mode, and owner on the same filesystem can be hardlinked
+    typedef tuple<dev_t,off_t,mode_t,uid_t,gid_t> CGroupKey;
+    map<CGroupKey, vector<size_t> > candidates;
+
+    for(size_t i=0; i < Files.size(); i++){
+        const SFileEntry& entry = Files[i];
+        if( entry.Size == 0 ) continue;
+        candidates[CGroupKey(entry.Dev,entry.Size,entry.Mode,entry.UID,entry.GID)].push_back(i);
+    }
+
+    // inodes without cached content hash, groups with a single inode are not hashed
+    vector<size_t>  todo;
+    set<CInodeKey>  queued;
+
+    map<CGroupKey, vector<size_t> >::iterator it = candidates.begin();
+    map<CGroupKey, vector<size_t> >::iterator ie = candidates.end();
+
+    while( it != ie ){
+        vector<size_t>& group = it->second;
+        set<CInodeKey>  inodes;
+        for(size_t idx : group) inodes.insert(CInodeKey(Files[idx].Dev,Files[idx].Ino));
+        if( inodes.size() < 2 ){
+            it = candidates.erase(it);
+            continue;
+        }
+        for(size_t idx : group){
+            CInodeKey key(Files[idx].Dev,Files[idx].Ino);
+            if( ContentHashes.count(key) == 1 ) continue;
+            if( queued.insert(key).second ) todo.push_back(idx);
+        }
+        it++;
+    }
+
+    // calculate content hashes in parallel, each thread writes only its own slots
+    vector<string> hashes(todo.size());
+
+    if( nthreads <= 0 ) nthreads = thread::hardware_concurrency();
+    if( nthreads <= 0 ) nthreads = 1;
+    if( (size_t)nthreads > todo.size() ) nthreads = todo.size();
+
+    auto worker = [this,&todo,&hashes,nthreads](int tid){
+        for(size_t i=tid; i < todo.size(); i += nthreads){
+            hashes[i] = CalculateContentHash(Files[todo[i]].Path);
+        }
+    };
+
+    if( nthreads > 0 ){
+        vector<thread> threads;
+        for(int tid=1; tid < nthreads; tid++){
+            threads.emplace_back(worker,tid);
+        }
+        worker(0);
+        for(thread& th : threads) th.join();
+    }
+
+    for(size_t i=0; i < todo.size(); i++){
+        ContentHashes[CInodeKey(Files[todo[i]].Dev,Files[todo[i]].Ino)] = hashes[i];
+    }
+    NumOfHashedFiles += todo.size();
+
+    // group files with identical content
+    for(it = candidates.begin(); it != candidates.end(); it++){
+        map<string, vector<size_t> > identical;
+        for(size_t idx : it->second){
+            const string& hash = ContentHashes[CInodeKey(Files[idx].Dev,Files[idx].Ino)];
+            if( hash.empty() ) continue;    // unreadable
+            identical[hash].push_back(idx);
+        }
+
+        map<string, vector<size_t> >::iterator dit = identical.begin();
+        map<string, vector<size_t> >::iterator die = identical.end();
 
+        while( dit != die ){
+            vector<size_t>& group = dit->second;
+            dit++;
+
+            set<CInodeKey>  inodes;
+            bool            cross_build = false;
+            size_t          linked = 0;
+            for(size_t idx : group){
+                if( inodes.insert(CInodeKey(Files[idx].Dev,Files[idx].Ino)).second == false ) linked++;
+                if( Files[idx].Build != Files[group[0]].Build ) cross_build = true;
+            }
+            if( inodes.size() < 2 ) continue;
+
+            NumOfRedundantFiles += inodes.size() - 1;
+            NumOfLinkedFiles    += linked;
+            RedundantSize       += (uint64_t)(inodes.size() - 1) * Files[group[0]].Size;
+            if( cross_build ) NumOfCrossBuildGroups++;
+
+            Duplicates.push_back(group);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CFSIndex::PrintDedupReport(CVerboseStr& vout)
+{
+    vout << endl;
+    vout << "# Deduplication report ..." << endl;
+    vout << "  > Number of builds                     = " << Builds.size() << endl;
+    vout << "  > Number of files                      = " << Files.size() << endl;
+    vout << "  > Number of content hashes             = " << NumOfHashedFiles << endl;
+    vout << "  > Number of groups of identical files  = " << Duplicates.size() << endl;
+    vout << "  > Number of groups across builds       = " << NumOfCrossBuildGroups << endl;
+    vout << "  > Number of redundant copies           = " << NumOfRedundantFiles << endl;
+    vout << "  > Number of already hardlinked files   = " << NumOfLinkedFiles << endl;
+    vout << "  > Reclaimable size (kB)                = " << RedundantSize / 1024 << endl;
+}
+
+//------------------------------------------------------------------------------
+
+void CFSIndex::PrintHardlinkPlan(CVerboseStr& vout)
+{
+    for(const vector<size_t>& group : Duplicates){
+        const SFileEntry& source = Files[group[0]];
+        const string& hash = ContentHashes[CInodeKey(source.Dev,source.Ino)];
+        for(size_t idx : group){
+            const SFileEntry& target = Files[idx];
+            if( target.Ino == source.Ino ) continue;     // the source itself or already hardlinked
+            vout << "L " << hash << " " << target.Size << " " << source.Path << " " << target.Path << endl;
+        }
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
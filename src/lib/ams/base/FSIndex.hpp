@@ -22,6 +22,12 @@
 
 #include <AMSMainHeader.hpp>
 #include <FileName.hpp>
+#include <VerboseStr.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <sys/types.h>
+#include <stdint.h>
 
 class SHA1;
 
@@ -41,11 +47,56 @@ public:
     void HashDir(const CFileName& full_path,SHA1& sha1);
     void HashNode(const CFileName& name,struct stat& my_stat,bool build_node,SHA1& sha1);
 
+// deduplication ---------------------------------------------------------------
+    /// find collected files with identical content, content hashes are calculated in parallel
+    void FindDuplicates(int nthreads=0);
+
+    /// print deduplication report
+    void PrintDedupReport(CVerboseStr& vout);
+
+    /// print hardlink plan - L sha1 size source target
+    void PrintHardlinkPlan(CVerboseStr& vout);
+
 public:
     CFileName   RootDir;
     bool        PersonalBundle;
     bool        IncludeParents;
+    bool        CollectFiles;       // collect regular files of hashed builds and directories
     int         NumOfStats;
+
+// section of private data -----------------------------------------------------
+private:
+    struct SFileEntry {
+        CFileName   Path;
+        dev_t       Dev;
+        ino_t       Ino;
+        off_t       Size;
+        mode_t      Mode;
+        uid_t       UID;
+        gid_t       GID;
+        int         Build;
+    };
+
+    typedef std::pair<dev_t,ino_t>  CInodeKey;
+
+    std::vector<CFileName>                  Builds;
+    int                                     CurrentBuild;
+    std::vector<SFileEntry>                 Files;
+    std::map<CInodeKey,std::string>         ContentHashes;  // inode-keyed cache
+    std::vector< std::vector<size_t> >      Duplicates;     // groups of identical files
+
+    // statistics
+    size_t      NumOfHashedFiles;
+    size_t      NumOfRedundantFiles;
+    size_t      NumOfLinkedFiles;
+    size_t      NumOfCrossBuildGroups;
+    uint64_t    RedundantSize;
+
+    /// register build for collected files
+    void RegisterBuild(const CFileName& full_path);
+
+    /// calculate hash of file content, empty string if the file cannot be read
+    static std::string CalculateContentHash(const CFileName& full_path);
 };
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,495 @@
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <ROXMLDocument.hpp>
+#include <XMLElement.hpp>
+#include <ErrorSystem.hpp>
+#include <fstream>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+const char* CROXMLElement::GetName(void) const
+{
+    return(Name);
+}
+
+//------------------------------------------------------------------------------
+
+const char* CROXMLElement::GetAttributeValue(const char* name) const
+{
+    for(unsigned int i=0; i < NumOfAttributes; i++){
+        if( strcmp(Attributes[i].Name,name) == 0 ) return(Attributes[i].Value);
+    }
+    return(NULL);
+}
+
+//------------------------------------------------------------------------------
+
+bool CROXMLElement::GetAttribute(const char* name,CSmallString& value) const
+{
+    const char* p_value = GetAttributeValue(name);
+    if( p_value == NULL ) return(false);
+    value = p_value;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CROXMLElement::GetAttribute(const char* name,bool& value) const
+{
+    const char* p_value = GetAttributeValue(name);
+    if( p_value == NULL ) return(false);
+    if( (strcmp(p_value,"true") == 0) || (strcmp(p_value,"1") == 0) ){
+        value = true;
+        return(true);
+    }
+    if( (strcmp(p_value,"false") == 0) || (strcmp(p_value,"0") == 0) ){
+        value = false;
+        return(true);
+    }
+    return(false);
+}
+
+//------------------------------------------------------------------------------
+
+bool CROXMLElement::GetAttribute(const char* name,int& value) const
+{
+    const char* p_value = GetAttributeValue(name);
+    if( p_value == NULL ) return(false);
+    char* p_end = NULL;
+    long lvalue = strtol(p_value,&p_end,10);
+    if( (p_end == p_value) || (*p_end != '\0') ) return(false);
+    value = lvalue;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CROXMLElement::GetAttribute(const char* name,double& value) const
+{
+    const char* p_value = GetAttributeValue(name);
+    if( p_value == NULL ) return(false);
+    char* p_end = NULL;
+    double lvalue = strtod(p_value,&p_end);
+    if( (p_end == p_value) || (*p_end != '\0') ) return(false);
+    value = lvalue;
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+const CROXMLElement* CROXMLElement::GetFirstChildElement(const char* name) const
+{
+    const CROXMLElement* p_ele = FirstChild;
+    if( name == NULL ) return(p_ele);
+    while( (p_ele != NULL) && (strcmp(p_ele->Name,name) != 0) ){
+        p_ele = p_ele->NextSibling;
+    }
+    return(p_ele);
+}
+
+//------------------------------------------------------------------------------
+
+const CROXMLElement* CROXMLElement::GetNextSiblingElement(const char* name) const
+{
+    const CROXMLElement* p_ele = NextSibling;
+    if( name == NULL ) return(p_ele);
+    while( (p_ele != NULL) && (strcmp(p_ele->Name,name) != 0) ){
+        p_ele = p_ele->NextSibling;
+    }
+    return(p_ele);
+}
+
+//------------------------------------------------------------------------------
+
+const CROXMLElement* CROXMLElement::GetChildElementByPath(const char* path) const
+{
+    if( (path == NULL) || (*path == '\0') ) return(NULL);
+
+    const CROXMLElement* p_ele = this;
+    const char* p_seg = path;
+
+    while( p_ele != NULL ){
+        const char* p_end = strchr(p_seg,'/');
+        size_t len = p_end != NULL ? (size_t)(p_end - p_seg) : strlen(p_seg);
+
+        const CROXMLElement* p_child = p_ele->FirstChild;
+        while( p_child != NULL ){
+            if( (strncmp(p_child->Name,p_seg,len) == 0) && (p_child->Name[len] == '\0') ) break;
+            p_child = p_child->NextSibling;
+        }
+        p_ele = p_child;
+
+        if( p_end == NULL ) break;
+        p_seg = p_end + 1;
+    }
+
+    return(p_ele);
+}
+
+//------------------------------------------------------------------------------
+
+CXMLElement* CROXMLElement::CopyToXMLNode(CXMLNode* p_parent) const
+{
+    if( p_parent == NULL ){
+        RUNTIME_ERROR("p_parent is NULL");
+    }
+
+    CXMLElement* p_ele = p_parent->CreateChildElement(Name);
+    for(unsigned int i=0; i < NumOfAttributes; i++){
+        p_ele->SetAttribute(Attributes[i].Name,CSmallString(Attributes[i].Value));
+    }
+
+    const CROXMLElement* p_child = FirstChild;
+    while( p_child != NULL ){
+        p_child->CopyToXMLNode(p_ele);
+        p_child = p_child->NextSibling;
+    }
+
+    return(p_ele);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CROXMLDocument::CROXMLDocument(void)
+{
+}
+
+//------------------------------------------------------------------------------
+
+void CROXMLDocument::Clear(void)
+{
+    Buffer.clear();
+    Elements.clear();
+    Attributes.clear();
+}
+
+//------------------------------------------------------------------------------
+
+bool CROXMLDocument::Load(const CFileName& name)
+{
+    Clear();
+
+    ifstream ifs(name,ios::in | ios::binary);
+    if( ! ifs ){
+        CSmallString error;
+        error << "unable to open file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    ifs.seekg(0,ios::end);
+    streamoff size = ifs.tellg();
+    ifs.seekg(0,ios::beg);
+    if( size < 0 ){
+        CSmallString error;
+        error << "unable to determine size of file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    Buffer.resize(size+1);
+    if( (size > 0) && (! ifs.read(&Buffer[0],size)) ){
+        Clear();
+        CSmallString error;
+        error << "unable to read file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+    Buffer[size] = '\0';
+
+    if( Parse() == false ){
+        Clear();
+        CSmallString error;
+        error << "unable to parse file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CROXMLDocument::IsLoaded(void) const
+{
+    return( ! Elements.empty() );
+}
+
+//------------------------------------------------------------------------------
+
+const CROXMLElement* CROXMLDocument::GetFirstChildElement(const char* name) const
+{
+    if( Elements.empty() ) return(NULL);
+    return( Elements[0].GetFirstChildElement(name) );
+}
+
+//------------------------------------------------------------------------------
+
+size_t CROXMLDocument::GetNumOfElements(void) const
+{
+    if( Elements.empty() ) return(0);
+    return( Elements.size() - 1 );
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CROXMLDocument::Parse(void)
+{
+    // elements are linked by indices during parsing as the arrays can be reallocated
+    std::vector<int>            first_child;
+    std::vector<int>            last_child;
+    std::vector<int>            next_sibling;
+    std::vector<unsigned int>   first_attr;
+    std::vector<int>            stack;
+
+    CROXMLElement root;
+    root.Name = "";
+    root.Attributes = NULL;
+    root.NumOfAttributes = 0;
+    root.FirstChild = NULL;
+    root.NextSibling = NULL;
+
+    Elements.push_back(root);
+    first_child.push_back(-1);
+    last_child.push_back(-1);
+    next_sibling.push_back(-1);
+    first_attr.push_back(0);
+    stack.push_back(0);
+
+    char* p = &Buffer[0];
+
+    for(;;){
+        // text is ignored
+        p = strchr(p,'<');
+        if( p == NULL ) break;
+
+        // declarations, comments, and CDATA sections
+        if( strncmp(p,"<?",2) == 0 ){
+            p = strstr(p+2,"?>");
+            if( p == NULL ) return(false);
+            p += 2;
+            continue;
+        }
+        if( strncmp(p,"<!--",4) == 0 ){
+            p = strstr(p+4,"-->");
+            if( p == NULL ) return(false);
+            p += 3;
+            continue;
+        }
+        if( strncmp(p,"<![CDATA[",9) == 0 ){
+            p = strstr(p+9,"]]>");
+            if( p == NULL ) return(false);
+            p += 3;
+            continue;
+        }
+        if( strncmp(p,"<!",2) == 0 ){
+            p = strchr(p+2,'>');
+            if( p == NULL ) return(false);
+            p++;
+            continue;
+        }
+
+        // end tag
+        if( p[1] == '/' ){
+            char* p_name = p + 2;
+            char* p_end = p_name;
+            while( (*p_end != '\0') && (*p_end != '>') && (isspace((unsigned char)*p_end) == 0) ) p_end++;
+            size_t len = p_end - p_name;
+            if( stack.size() <= 1 ) return(false);
+            const char* p_open = Elements[stack.back()].Name;
+            if( (strncmp(p_open,p_name,len) != 0) || (p_open[len] != '\0') ) return(false);
+            p = strchr(p_end,'>');
+            if( p == NULL ) return(false);
+            p++;
+            stack.pop_back();
+            continue;
+        }
+
+        // start tag
+        char* p_name = p + 1;
+        char* p_end = p_name;
+        while( (*p_end != '\0') && (*p_end != '/') && (*p_end != '>') && (isspace((unsigned char)*p_end) == 0) ) p_end++;
+        if( (p_end == p_name) || (*p_end == '\0') ) return(false);
+
+        int index = Elements.size();
+        CROXMLElement element;
+        element.Name = p_name;
+        element.Attributes = NULL;
+        element.NumOfAttributes = 0;
+        element.FirstChild = NULL;
+        element.NextSibling = NULL;
+        Elements.push_back(element);
+        first_child.push_back(-1);
+        last_child.push_back(-1);
+        next_sibling.push_back(-1);
+        first_attr.push_back(Attributes.size());
+
+        int parent = stack.back();
+        if( last_child[parent] < 0 ){
+            first_child[parent] = index;
+        } else {
+            next_sibling[last_child[parent]] = index;
+        }
+        last_child[parent] = index;
+
+        // terminate name in place, c is the overwritten character
+        char c = *p_end;
+        *p_end = '\0';
+        p = p_end;
+
+        // attributes
+        for(;;){
+            while( isspace((unsigned char)c) != 0 ){
+                p++;
+                c = *p;
+            }
+            if( c == '>' ){
+                p++;
+                stack.push_back(index);
+                break;
+            }
+            if( c == '/' ){
+                if( p[1] != '>' ) return(false);
+                p += 2;
+                break;
+            }
+            if( c == '\0' ) return(false);
+
+            char* p_aname = p;
+            while( (*p != '\0') && (*p != '=') && (isspace((unsigned char)*p) == 0) ) p++;
+            char* p_aname_end = p;
+            while( isspace((unsigned char)*p) != 0 ) p++;
+            if( *p != '=' ) return(false);
+            p++;
+            *p_aname_end = '\0';
+
+            while( isspace((unsigned char)*p) != 0 ) p++;
+            char quote = *p;
+            if( (quote != '"') && (quote != '\'') ) return(false);
+            char* p_value = ++p;
+            p = strchr(p,quote);
+            if( p == NULL ) return(false);
+            *p = '\0';
+            p++;
+            if( DecodeEntities(p_value) == false ) return(false);
+
+            CROXMLAttribute attr;
+            attr.Name = p_aname;
+            attr.Value = p_value;
+            Attributes.push_back(attr);
+            Elements[index].NumOfAttributes++;
+
+            c = *p;
+        }
+    }
+
+    if( stack.size() != 1 ) return(false);
+
+    // arrays are final - convert indices to pointers
+    for(size_t i=0; i < Elements.size(); i++){
+        CROXMLElement& ele = Elements[i];
+        if( ele.NumOfAttributes > 0 ) ele.Attributes = &Attributes[first_attr[i]];
+        if( first_child[i] >= 0 ) ele.FirstChild = &Elements[first_child[i]];
+        if( next_sibling[i] >= 0 ) ele.NextSibling = &Elements[next_sibling[i]];
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CROXMLDocument::DecodeEntities(char* p_str)
+{
+    // decoded text is never longer than the encoded one
+    char* p_r = p_str;
+    char* p_w = p_str;
+
+    while( *p_r != '\0' ){
+        if( *p_r != '&' ){
+            *p_w++ = *p_r++;
+            continue;
+        }
+        char* p_semi = strchr(p_r,';');
+        if( p_semi == NULL ) return(false);
+        const char* p_ent = p_r + 1;
+        size_t      len = p_semi - p_ent;
+
+        if( (len == 2) && (strncmp(p_ent,"lt",2) == 0) ){
+            *p_w++ = '<';
+        } else if( (len == 2) && (strncmp(p_ent,"gt",2) == 0) ){
+            *p_w++ = '>';
+        } else if( (len == 3) && (strncmp(p_ent,"amp",3) == 0) ){
+            *p_w++ = '&';
+        } else if( (len == 4) && (strncmp(p_ent,"quot",4) == 0) ){
+            *p_w++ = '"';
+        } else if( (len == 4) && (strncmp(p_ent,"apos",4) == 0) ){
+            *p_w++ = '\'';
+        } else if( (len > 1) && (p_ent[0] == '#') ){
+            unsigned long code;
+            if( (p_ent[1] == 'x') || (p_ent[1] == 'X') ){
+                code = strtoul(p_ent+2,NULL,16);
+            } else {
+                code = strtoul(p_ent+1,NULL,10);
+            }
+            // UTF-8
+            if( code < 0x80 ){
+                *p_w++ = code;
+            } else if( code < 0x800 ){
+                *p_w++ = 0xC0 | (code >> 6);
+                *p_w++ = 0x80 | (code & 0x3F);
+            } else if( code < 0x10000 ){
+                *p_w++ = 0xE0 | (code >> 12);
+                *p_w++ = 0x80 | ((code >> 6) & 0x3F);
+                *p_w++ = 0x80 | (code & 0x3F);
+            } else {
+                *p_w++ = 0xF0 | (code >> 18);
+                *p_w++ = 0x80 | ((code >> 12) & 0x3F);
+                *p_w++ = 0x80 | ((code >> 6) & 0x3F);
+                *p_w++ = 0x80 | (code & 0x3F);
+            }
+        } else {
+            return(false);
+        }
+        p_r = p_semi + 1;
+    }
+    *p_w = '\0';
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
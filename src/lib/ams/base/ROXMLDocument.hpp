@@ -0,0 +1,132 @@
+#ifndef ROXMLDocumentH
+#define ROXMLDocumentH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <FileName.hpp>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+
+class CXMLNode;
+class CXMLElement;
+
+// -----------------------------------------------------------------------------
+
+/// attribute of read-only element, strings point into the document buffer
+struct CROXMLAttribute {
+    const char* Name;
+    const char* Value;
+};
+
+// -----------------------------------------------------------------------------
+
+/// element of read-only document
+class AMS_PACKAGE CROXMLElement {
+public:
+// information methods ---------------------------------------------------------
+    /// get element name
+    const char* GetName(void) const;
+
+    /// get attribute value or NULL if the attribute does not exist
+    const char* GetAttributeValue(const char* name) const;
+
+    /// get attribute value
+    bool GetAttribute(const char* name,CSmallString& value) const;
+
+    /// get attribute value
+    bool GetAttribute(const char* name,bool& value) const;
+
+    /// get attribute value
+    bool GetAttribute(const char* name,int& value) const;
+
+    /// get attribute value
+    bool GetAttribute(const char* name,double& value) const;
+
+// navigation methods ----------------------------------------------------------
+    /// get the first child element with given name, any element if name is NULL
+    const CROXMLElement* GetFirstChildElement(const char* name=NULL) const;
+
+    /// get the next sibling element with given name, any element if name is NULL
+    const CROXMLElement* GetNextSiblingElement(const char* name=NULL) const;
+
+    /// get child element by path, e.g. "builds/build"
+    const CROXMLElement* GetChildElementByPath(const char* path) const;
+
+// conversion ------------------------------------------------------------------
+    /// copy the element and its subtree into a standard XML tree
+    CXMLElement* CopyToXMLNode(CXMLNode* p_parent) const;
+
+// section of private data -----------------------------------------------------
+private:
+    const char*             Name;
+    const CROXMLAttribute*  Attributes;
+    unsigned int            NumOfAttributes;
+    const CROXMLElement*    FirstChild;
+    const CROXMLElement*    NextSibling;
+
+    friend class CROXMLDocument;
+};
+
+// -----------------------------------------------------------------------------
+
+/// read-only XML document - the file is loaded into a single buffer, which is
+/// parsed in place, elements and attributes are stored in two arrays,
+/// text nodes, comments, and declarations are skipped
+class AMS_PACKAGE CROXMLDocument {
+public:
+// constructor -----------------------------------------------------------------
+    CROXMLDocument(void);
+
+// setup methods ---------------------------------------------------------------
+    /// load and parse file
+    bool Load(const CFileName& name);
+
+    /// release all data
+    void Clear(void);
+
+// information methods ---------------------------------------------------------
+    /// was a document loaded?
+    bool IsLoaded(void) const;
+
+    /// get the first top-level element with given name
+    const CROXMLElement* GetFirstChildElement(const char* name=NULL) const;
+
+    /// get number of elements
+    size_t GetNumOfElements(void) const;
+
+// helpers ---------------------------------------------------------------------
+    /// decode entities in place
+    static bool DecodeEntities(char* p_str);
+
+// section of private data -----------------------------------------------------
+private:
+    std::vector<char>               Buffer;         // file content, modified by parser
+    std::vector<CROXMLElement>      Elements;       // the first element is the document root
+    std::vector<CROXMLAttribute>    Attributes;
+
+    /// parse buffer
+    bool Parse(void);
+};
+
+// -----------------------------------------------------------------------------
+
+#endif
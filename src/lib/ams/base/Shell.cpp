@@ -24,6 +24,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sstream>
+#include <vector>
+#include <string>
 
 //==============================================================================
 //------------------------------------------------------------------------------
@@ -48,22 +50,11 @@ const CSmallString CShell::RemoveValue(const CSmallString& value_list,
         const CSmallString& value,
         const CSmallString& delimiter)
 {
-    CSmallString     tmp(value_list);
-    CSmallString     newlist;
-    char*             p_lval;
+    if( value_list == NULL ) return("");
 
-    if( tmp == NULL ) return(newlist);
-
-    p_lval = strtok(tmp.GetBuffer(),delimiter);
-    while( p_lval != NULL ) {
-        if( (strcmp(p_lval,value) != 0) && (strlen(p_lval) != 0) ) {
-            if( (newlist != NULL)&&(strlen(newlist) > 0) ) newlist += delimiter;
-            newlist += p_lval;
-        }
-        p_lval = strtok(NULL,delimiter);
-    }
-
-    return(newlist);
+    std::vector<CSmallString> removed;
+    removed.push_back(value);
+    return( EditValueList(value_list,removed,NULL,NULL,delimiter) );
 }
 
 //------------------------------------------------------------------------------
@@ -73,17 +64,15 @@ const CSmallString CShell::AppendValue(const CSmallString& value_list,
         const CSmallString& delimiter)
 {
     if( value == NULL ) return(value_list);
+    if( value_list.GetLength() == 0 ) return(value);
 
-    CSmallString     newlist(value_list);
+    std::string newlist;
+    newlist.reserve(value_list.GetLength() + delimiter.GetLength() + value.GetLength());
+    newlist.append(value_list,value_list.GetLength());
+    newlist.append(delimiter,delimiter.GetLength());
+    newlist.append(value,value.GetLength());
 
-    if( (newlist != NULL) && (newlist.GetLength() > 0) ) {
-        newlist += delimiter;
-        newlist += value;
-    } else {
-        newlist = value;
-    }
-
-    return(newlist);
+    return(newlist.c_str());
 }
 
 //------------------------------------------------------------------------------
@@ -93,15 +82,86 @@ const CSmallString CShell::PrependValue(const CSmallString& value_list,
         const CSmallString& delimiter)
 {
     if( value == NULL ) return(value_list);
+    if( value_list.GetLength() == 0 ) return(value);
+
+    std::string newlist;
+    newlist.reserve(value_list.GetLength() + delimiter.GetLength() + value.GetLength());
+    newlist.append(value,value.GetLength());
+    newlist.append(delimiter,delimiter.GetLength());
+    newlist.append(value_list,value_list.GetLength());
 
-    CSmallString     newlist(value);
+    return(newlist.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+const CSmallString CShell::EditValueList(const CSmallString& value_list,
+        const std::vector<CSmallString>& removed,
+        const CSmallString& prepend,
+        const CSmallString& append,
+        const CSmallString& delimiter)
+{
+    size_t llen = value_list.GetLength();
+    size_t plen = prepend.GetLength();
+    size_t alen = append.GetLength();
+    size_t dlen = delimiter.GetLength();
+
+    // the result is never longer than this
+    std::string newlist;
+    newlist.reserve(plen + dlen + llen + dlen + alen);
+
+    if( plen > 0 ) newlist.append(prepend,plen);
+
+    if( llen > 0 ){
+        size_t pos = newlist.size();
+        if( pos > 0 ) newlist.append(delimiter,dlen);
+        FilterValueList(newlist,value_list,llen,removed,delimiter,dlen);
+        // nothing was copied
+        if( (pos > 0) && (newlist.size() == pos + dlen) ) newlist.resize(pos);
+    }
 
-    if( (value_list != NULL) && (value_list.GetLength() > 0) ) {
-        newlist += delimiter;
-        newlist += value_list;
+    if( alen > 0 ){
+        if( newlist.size() > 0 ) newlist.append(delimiter,dlen);
+        newlist.append(append,alen);
     }
 
-    return(newlist);
+    return(newlist.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+void CShell::FilterValueList(std::string& out,const char* p_list,size_t len,
+        const std::vector<CSmallString>& removed,
+        const char* p_delim,size_t dlen)
+{
+    const char* p_end = p_list + len;
+    bool        first = true;
+
+    while( p_list < p_end ){
+        // find the end of item - any character of delimiter terminates the item (as strtok)
+        // memchr is vectorised in libc, which matters for long PATH-like variables
+        const char* p_stop;
+        if( dlen == 1 ){
+            p_stop = (const char*)memchr(p_list,p_delim[0],p_end - p_list);
+        } else {
+            p_stop = p_list + strcspn(p_list,p_delim);
+        }
+        if( (p_stop == NULL) || (p_stop > p_end) ) p_stop = p_end;
+
+        size_t ilen = p_stop - p_list;
+        bool   keep = ilen > 0;
+        for(size_t i=0; keep && (i < removed.size()); i++){
+            if( ((size_t)removed[i].GetLength() == ilen) && (memcmp(p_list,removed[i],ilen) == 0) ) keep = false;
+        }
+
+        if( keep ){
+            if( first == false ) out.append(p_delim,dlen);
+            out.append(p_list,ilen);
+            first = false;
+        }
+
+        p_list = p_stop + 1;
+    }
 }
 
 //==============================================================================
@@ -24,6 +24,8 @@
 
 #include <AMSMainHeader.hpp>
 #include <SmallString.hpp>
+#include <vector>
+#include <string>
 
 //------------------------------------------------------------------------------
 
@@ -49,6 +51,22 @@ public:
     static const CSmallString PrependValue(const CSmallString& value_list,
             const CSmallString& value,
             const CSmallString& delimiter);
+
+    /// remove values from list of values separated by delimiter, then prepend
+    /// and append values (NULL - nothing), empty items are dropped,
+    /// the list is scanned only once
+    static const CSmallString EditValueList(const CSmallString& value_list,
+            const std::vector<CSmallString>& removed,
+            const CSmallString& prepend,
+            const CSmallString& append,
+            const CSmallString& delimiter);
+
+// section of private data -----------------------------------------------------
+private:
+    /// copy items of list to out except of removed and empty ones
+    static void FilterValueList(std::string& out,const char* p_list,size_t len,
+            const std::vector<CSmallString>& removed,
+            const char* p_delim,size_t dlen);
 };
 
 //------------------------------------------------------------------------------
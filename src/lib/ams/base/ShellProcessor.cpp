@@ -28,6 +28,8 @@
 #include <iomanip>
 #include <ShellProcessor.hpp>
 #include <ErrorSystem.hpp>
+#include <AMSProfiler.hpp>
+#include <vector>
 
 //------------------------------------------------------------------------------
 
@@ -54,6 +56,9 @@ CShellProcessor::CShellProcessor(void)
 
 bool CShellProcessor::PrepareModuleEnvironmentForDeps(CXMLElement* p_build)
 {
+    // precompiled by ams-bundle rebuild
+    if( ExecuteSetupProgram(p_build,"deps") == true ) return(true);
+
     CXMLElement* p_setup = NULL;
     if( p_build != NULL ) p_setup = p_build->GetFirstChildElement("setup");
 
@@ -134,6 +139,9 @@ bool CShellProcessor::PrepareModuleEnvironmentForDeps(CXMLElement* p_build)
 bool CShellProcessor::PrepareModuleEnvironmentForModActionI(
                             CXMLElement* p_build)
 {
+    // precompiled by ams-bundle rebuild
+    if( ExecuteSetupProgram(p_build,"modaction") == true ) return(true);
+
     CXMLElement* p_setup = NULL;
     if( p_build != NULL ) p_setup = p_build->GetFirstChildElement("setup");
 
@@ -214,6 +222,9 @@ bool CShellProcessor::PrepareModuleEnvironmentForModActionI(
 bool CShellProcessor::PrepareModuleEnvironmentForModActionII(
                             CXMLElement* p_build)
 {
+    // precompiled by ams-bundle rebuild
+    if( ExecuteSetupProgram(p_build,"modremove") == true ) return(true);
+
     CXMLElement* p_setup = NULL;
     if( p_build != NULL ) p_setup = p_build->GetFirstChildElement("setup");
 
@@ -284,6 +295,13 @@ bool CShellProcessor::PrepareModuleEnvironmentForModActionII(
 bool CShellProcessor::PrepareModuleEnvironmentForLowPriority(CXMLElement* p_build,
                                                              EModuleAction action)
 {
+    // precompiled by ams-bundle rebuild, removal order is already reversed
+    if( action == EMA_ADD_MODULE ) {
+        if( ExecuteSetupProgram(p_build,"lowadd") == true ) return(true);
+    } else {
+        if( ExecuteSetupProgram(p_build,"lowremove") == true ) return(true);
+    }
+
     CSimpleList<CXMLElement> CommandList;
     CXMLElement* p_sele;
 
@@ -405,6 +423,207 @@ bool CShellProcessor::PrepareModuleEnvironmentForLowPriority(CXMLElement* p_buil
 //------------------------------------------------------------------------------
 //==============================================================================
 
+void CShellProcessor::CompileSetupProgram(CXMLElement* p_build)
+{
+    if( p_build == NULL ){
+        RUNTIME_ERROR("no build");
+    }
+
+    // remove previous program
+    CXMLElement* p_prog = p_build->GetFirstChildElement("program");
+    if( p_prog != NULL ) delete p_prog;
+
+    p_prog = p_build->CreateChildElement("program");
+
+    // sections correspond to PrepareModuleEnvironmentFor* passes
+    CXMLElement* p_deps      = p_prog->CreateChildElement("deps");
+    CXMLElement* p_modaction = p_prog->CreateChildElement("modaction");
+    CXMLElement* p_lowadd    = p_prog->CreateChildElement("lowadd");
+    CXMLElement* p_lowremove = p_prog->CreateChildElement("lowremove");
+    CXMLElement* p_modremove = p_prog->CreateChildElement("modremove");
+
+    CXMLElement* p_setup = p_build->GetFirstChildElement("setup");
+
+    std::vector<CXMLElement*> lowelems;
+
+    CXMLIterator CI(p_setup);
+    CXMLElement* p_sele;
+
+    while( (p_sele = CI.GetNextChildElement()) != NULL ) {
+        CSmallString lpriority;
+        p_sele->GetAttribute("priority",lpriority);
+
+        if( lpriority == "dependency" ) {
+            AddSetupOperation(p_deps,p_sele);
+        }
+        if( lpriority == "modaction" ) {
+            AddSetupOperation(p_modaction,p_sele);
+        } else {
+            AddSetupOperation(p_lowadd,p_sele);
+            lowelems.push_back(p_sele);
+        }
+        if( (lpriority == "modaction") || (lpriority == "dependency") ) {
+            AddSetupReverseOperation(p_modremove,p_sele);
+        }
+    }
+
+    // unload is in reverse order
+    for(std::vector<CXMLElement*>::reverse_iterator it = lowelems.rbegin(); it != lowelems.rend(); it++){
+        AddSetupReverseOperation(p_lowremove,*it);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CShellProcessor::AddSetupOperation(CXMLElement* p_sec,CXMLElement* p_sele)
+{
+    CSmallString name;
+    CSmallString value;
+    p_sele->GetAttribute("name",name);
+
+    if( p_sele->GetName() == "variable" ) {
+        CSmallString operation;
+        p_sele->GetAttribute("value",value);
+        p_sele->GetAttribute("operation",operation);
+
+        CSmallString type;
+        if( (operation == "append") || (operation == "prepend") || (operation == "unset") ) {
+            type = operation;
+        }
+        if( (operation == "set") || (operation == "keep") ) {
+            type = "set";
+        }
+        if( type == NULL ) return;
+
+        CXMLElement* p_op = p_sec->CreateChildElement("op");
+        p_op->SetAttribute("t",type);
+        p_op->SetAttribute("n",name);
+        if( type != "unset" ) p_op->SetAttribute("v",value);
+    }
+
+    if( p_sele->GetName() == "script" ) {
+        CSmallString type;
+        p_sele->GetAttribute("type",type);
+
+        CXMLElement* p_op = p_sec->CreateChildElement("op");
+        p_op->SetAttribute("t","script");
+        p_op->SetAttribute("n",name);
+        p_op->SetAttribute("a","add");
+        p_op->SetAttribute("i",type == "inline");
+    }
+
+    if( p_sele->GetName() == "alias" ) {
+        p_sele->GetAttribute("value",value);
+
+        CXMLElement* p_op = p_sec->CreateChildElement("op");
+        p_op->SetAttribute("t","alias");
+        p_op->SetAttribute("n",name);
+        p_op->SetAttribute("v",value);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CShellProcessor::AddSetupReverseOperation(CXMLElement* p_sec,CXMLElement* p_sele)
+{
+    CSmallString name;
+    CSmallString value;
+    p_sele->GetAttribute("name",name);
+
+    if( p_sele->GetName() == "variable" ) {
+        CSmallString operation;
+        p_sele->GetAttribute("value",value);
+        p_sele->GetAttribute("operation",operation);
+
+        // keep and unset do nothing on removal
+        if( (operation == "append") || (operation == "prepend") ) {
+            CXMLElement* p_op = p_sec->CreateChildElement("op");
+            p_op->SetAttribute("t","remove");
+            p_op->SetAttribute("n",name);
+            p_op->SetAttribute("v",value);
+        }
+        if( operation == "set" ) {
+            CXMLElement* p_op = p_sec->CreateChildElement("op");
+            p_op->SetAttribute("t","unset");
+            p_op->SetAttribute("n",name);
+        }
+    }
+
+    if( p_sele->GetName() == "script" ) {
+        CSmallString type;
+        p_sele->GetAttribute("type",type);
+
+        CXMLElement* p_op = p_sec->CreateChildElement("op");
+        p_op->SetAttribute("t","script");
+        p_op->SetAttribute("n",name);
+        p_op->SetAttribute("a","remove");
+        p_op->SetAttribute("i",type == "inline");
+    }
+
+    if( p_sele->GetName() == "alias" ) {
+        CXMLElement* p_op = p_sec->CreateChildElement("op");
+        p_op->SetAttribute("t","unalias");
+        p_op->SetAttribute("n",name);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool CShellProcessor::ExecuteSetupProgram(CXMLElement* p_build,const CSmallString& section)
+{
+    if( p_build == NULL ) return(false);
+
+    CXMLElement* p_prog = p_build->GetFirstChildElement("program");
+    if( p_prog == NULL ) return(false);
+
+    CXMLElement* p_sec = p_prog->GetFirstChildElement(section);
+    if( p_sec == NULL ) return(false);
+
+    CXMLElement* p_op = p_sec->GetFirstChildElement("op");
+    while( p_op != NULL ) {
+        CSmallString type;
+        CSmallString name;
+        CSmallString value;
+        p_op->GetAttribute("t",type);
+        p_op->GetAttribute("n",name);
+        p_op->GetAttribute("v",value);
+
+        if( type == "prepend" ) {
+            PrependValueToVariable(name,value,":");
+        } else if( type == "append" ) {
+            AppendValueToVariable(name,value,":");
+        } else if( type == "remove" ) {
+            RemoveValueFromVariable(name,value,":");
+        } else if( type == "set" ) {
+            SetVariable(name,value);
+        } else if( type == "unset" ) {
+            UnsetVariable(name);
+        } else if( type == "script" ) {
+            CSmallString args;
+            bool         inline_script = false;
+            p_op->GetAttribute("a",args);
+            p_op->GetAttribute("i",inline_script);
+            if( inline_script ){
+                RegisterScript(name,args,EST_INLINE);
+            } else {
+                RegisterScript(name,args,EST_CHILD);
+            }
+        } else if( type == "alias" ) {
+            SetAlias(name,value);
+        } else if( type == "unalias" ) {
+            UnsetAlias(name);
+        }
+
+        p_op = p_op->GetNextSiblingElement("op");
+    }
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
 void CShellProcessor::PrependValueToVariable(const CSmallString& name,
                                             const CSmallString& value,
                                             const CSmallString& delimiter)
@@ -526,6 +745,24 @@ void CShellProcessor::UnsetVariable(const CSmallString& name)
     p_sele->SetAttribute("remove",true);
 }
 
+//------------------------------------------------------------------------------
+
+void CShellProcessor::SetDeferredVariable(const CSmallString& name,
+                                          const CSmallString& value)
+{
+    DeferredVariables[std::string(name)] = std::string(value);
+}
+
+//------------------------------------------------------------------------------
+
+void CShellProcessor::FlushDeferredVariables(void)
+{
+    for(auto& var : DeferredVariables){
+        SetVariable(var.first.c_str(),var.second.c_str());
+    }
+    DeferredVariables.clear();
+}
+
 //==============================================================================
 //------------------------------------------------------------------------------
 //==============================================================================
@@ -647,6 +884,9 @@ void CShellProcessor::ChangeCurrentDir(const CFileName& path,bool silent)
 
 void CShellProcessor::ExecuteCMD(const CSmallString& cmd)
 {
+    // the command can read deferred variables
+    FlushDeferredVariables();
+
     CXMLElement* p_ele = ShellActions.GetFirstChildElement("actions");
     if( p_ele == NULL ){
         LOGIC_ERROR("p_ele is NULL");
@@ -665,6 +905,9 @@ void CShellProcessor::RegisterScript(const CSmallString& name,
         const CSmallString& args,
         EScriptType type)
 {
+    // the script can read deferred variables
+    FlushDeferredVariables();
+
     CXMLElement* p_ele = ShellActions.GetFirstChildElement("actions");
     if( p_ele == NULL ){
         LOGIC_ERROR("p_ele is NULL");
@@ -693,6 +936,7 @@ void CShellProcessor::SetExitCode(int exitcode)
 bool CShellProcessor::RollBack(void)
 {
     ExitCode = 0;
+    DeferredVariables.clear();
     ShellActions.RemoveAllChildNodes();
     ShellActions.CreateChildElement("actions");
     return(true);
@@ -700,12 +944,40 @@ bool CShellProcessor::RollBack(void)
 
 //------------------------------------------------------------------------------
 
+void CShellProcessor::SaveActions(CXMLElement* p_ele)
+{
+    CXMLElement* p_actions = ShellActions.GetFirstChildElement("actions");
+    if( (p_ele == NULL) || (p_actions == NULL) ){
+        LOGIC_ERROR("p_ele or p_actions is NULL");
+    }
+    FlushDeferredVariables();
+    p_ele->CopyChildNodesFrom(p_actions);
+}
+
+//------------------------------------------------------------------------------
+
+void CShellProcessor::RestoreActions(CXMLElement* p_ele)
+{
+    if( p_ele == NULL ){
+        LOGIC_ERROR("p_ele is NULL");
+    }
+    ShellActions.RemoveAllChildNodes();
+    CXMLElement* p_actions = ShellActions.CreateChildElement("actions");
+    p_actions->CopyChildNodesFrom(p_ele);
+}
+
+//------------------------------------------------------------------------------
+
 void CShellProcessor::BuildEnvironment(void)
 {
+    CAMSProfilerPhase phase("shell-emit");
+
     CSmallString exit_code;
 
     exit_code.IntToStr(ExitCode);
 
+    FlushDeferredVariables();
+
     // set exit code variable
     SetVariable("AMS_EXIT_CODE",exit_code);
 
@@ -715,6 +987,13 @@ void CShellProcessor::BuildEnvironment(void)
         LOGIC_ERROR("p_ele is NULL");
     }
 
+    // list operations are evaluated by the shell itself, forking _ams-module-var
+    // for each of them was too expensive for modules with many path edits
+    bool list_ops = HasListOperations(p_ele);
+    if( list_ops ){
+        PrintListOperationHelper();
+    }
+
     CXMLElement*     p_sele;
     CXMLIterator    I(p_ele);
 
@@ -757,9 +1036,9 @@ void CShellProcessor::BuildEnvironment(void)
             p_sele->GetAttribute("name",name);
             p_sele->GetAttribute("value",value);
             p_sele->GetAttribute("delimiter",delimiter);
-            printf("export %s=`$AMS_ROOT_V9/bin/_ams-module-var prepend \"$%s\" \"%s\" \"%s\"`;\n",
-                   (const char*)name,(const char*)name,
-                   (const char*)delimiter,(const char*)value);
+            printf("_ams_var_op %s \"$%s\" \"%s\" \"%s\"; export %s=\"$_ams_vv\";\n",
+                   "p",(const char*)name,(const char*)delimiter,(const char*)value,
+                   (const char*)name);
         }
 
         if( p_sele->GetName() == "append" ) {
@@ -769,9 +1048,9 @@ void CShellProcessor::BuildEnvironment(void)
             p_sele->GetAttribute("name",name);
             p_sele->GetAttribute("value",value);
             p_sele->GetAttribute("delimiter",delimiter);
-            printf("export %s=`$AMS_ROOT_V9/bin/_ams-module-var append \"$%s\" \"%s\" \"%s\"`;\n",
-                   (const char*)name,(const char*)name,
-                   (const char*)delimiter,(const char*)value);
+            printf("_ams_var_op %s \"$%s\" \"%s\" \"%s\"; export %s=\"$_ams_vv\";\n",
+                   "a",(const char*)name,(const char*)delimiter,(const char*)value,
+                   (const char*)name);
         }
 
         if( p_sele->GetName() == "remove" ) {
@@ -781,9 +1060,9 @@ void CShellProcessor::BuildEnvironment(void)
             p_sele->GetAttribute("name",name);
             p_sele->GetAttribute("value",value);
             p_sele->GetAttribute("delimiter",delimiter);
-            printf("export %s=`$AMS_ROOT_V9/bin/_ams-module-var remove \"$%s\" \"%s\" \"%s\"`;\n",
-                   (const char*)name,(const char*)name,
-                   (const char*)delimiter,(const char*)value);
+            printf("_ams_var_op %s \"$%s\" \"%s\" \"%s\"; export %s=\"$_ams_vv\";\n",
+                   "r",(const char*)name,(const char*)delimiter,(const char*)value,
+                   (const char*)name);
         }
 
         if( p_sele->GetName() == "script" ) {
@@ -871,6 +1150,40 @@ void CShellProcessor::BuildEnvironment(void)
         }
 
     }
+
+    if( list_ops ){
+        printf("unset -f _ams_var_op; unset _ams_vv _ams_vr _ams_vi;\n");
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool CShellProcessor::HasListOperations(CXMLElement* p_ele)
+{
+    CXMLElement*    p_sele;
+    CXMLIterator    I(p_ele);
+
+    while( (p_sele = I.GetNextChildElement()) != NULL ) {
+        if( (p_sele->GetName() == "prepend") || (p_sele->GetName() == "append") ||
+            (p_sele->GetName() == "remove") ) return(true);
+    }
+    return(false);
+}
+
+//------------------------------------------------------------------------------
+
+void CShellProcessor::PrintListOperationHelper(void)
+{
+    // _ams_var_op op list delimiter value - result is in _ams_vv
+    // semantics is the same as CShell::RemoveValue followed by CShell::PrependValue
+    // or CShell::AppendValue, i.e. what _ams-module-var does, empty items are dropped
+    printf("_ams_var_op(){ _ams_vv=\"\"; _ams_vr=\"$2$3\"; ");
+    printf("while [ -n \"$_ams_vr\" ]; do _ams_vi=\"${_ams_vr%%%%\"$3\"*}\"; _ams_vr=\"${_ams_vr#*\"$3\"}\"; ");
+    printf("if [ -n \"$_ams_vi\" ] && [ \"$_ams_vi\" != \"$4\" ]; then _ams_vv=\"${_ams_vv:+$_ams_vv$3}$_ams_vi\"; fi; done; ");
+    printf("if [ -n \"$4\" ]; then case \"$1\" in ");
+    printf("p) _ams_vv=\"$4${_ams_vv:+$3$_ams_vv}\";; ");
+    printf("a) _ams_vv=\"${_ams_vv:+$_ams_vv$3}$4\";; ");
+    printf("esac; fi; };\n");
 }
 
 //==============================================================================
@@ -25,6 +25,8 @@
 #include <AMSMainHeader.hpp>
 #include <XMLDocument.hpp>
 #include <FileName.hpp>
+#include <map>
+#include <string>
 
 //-----------------------------------------------------------------------------
 
@@ -49,6 +51,10 @@ public:
     /// print info about builds
     static void PrintBuild(std::ostream& vout,CXMLElement* p_build);
 
+// setup programs --------------------------------------------------------------
+    /// compile build setup into pre-bucketed programs (<program> element)
+    static void CompileSetupProgram(CXMLElement* p_build);
+
 // executive methods -----------------------------------------------------------
     /// set exit code
     void SetExitCode(int exitcode);
@@ -59,6 +65,13 @@ public:
     /// build shell environment
     void BuildEnvironment(void);
 
+// activation cache ------------------------------------------------------------
+    /// copy recorded actions into the element
+    void SaveActions(CXMLElement* p_ele);
+
+    /// replace recorded actions by actions from the element
+    void RestoreActions(CXMLElement* p_ele);
+
 // setup methods ---------------------------------------------------------------
     /// update environment according to module specification and variable priority
     bool PrepareModuleEnvironmentForDeps(CXMLElement* p_build);
@@ -93,6 +106,10 @@ public:
     /// unset variable
     void UnsetVariable(const CSmallString& name);
 
+    /// set variable before the next script or exec action or at the end
+    /// only the last value is written
+    void SetDeferredVariable(const CSmallString& name,const CSmallString& value);
+
     /// register script
     void RegisterScript(const CSmallString& name,
                                      const CSmallString& args,EScriptType type);
@@ -130,9 +147,30 @@ private:
     CXMLDocument        ShellActions;
     CSmallString        CurrentUMask;
 
+    /// variables written by FlushDeferredVariables
+    std::map<std::string,std::string>   DeferredVariables;
+
     /// final exit code set by module system as _MODULE_EXIT_CODE
     int            ExitCode;
 
+    /// write deferred variables
+    void FlushDeferredVariables(void);
+
+    /// execute precompiled program section, false if the build is not compiled
+    bool ExecuteSetupProgram(CXMLElement* p_build,const CSmallString& section);
+
+    /// add operation activating the setup element into the program section
+    static void AddSetupOperation(CXMLElement* p_sec,CXMLElement* p_sele);
+
+    /// add operation deactivating the setup element into the program section
+    static void AddSetupReverseOperation(CXMLElement* p_sec,CXMLElement* p_sele);
+
+    /// are there any prepend/append/remove actions?
+    static bool HasListOperations(CXMLElement* p_ele);
+
+    /// print shell function evaluating prepend/append/remove actions
+    static void PrintListOperationHelper(void);
+
     /// get sizes for build print
     static void GetMaxSizesForBuild(CXMLElement* p_ele,
             unsigned int& col1,unsigned int& col2,
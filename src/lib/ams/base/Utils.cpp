@@ -41,6 +41,8 @@
 #include <boost/algorithm/string/join.hpp>
 #include <XMLElement.hpp>
 #include <fnmatch.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 //------------------------------------------------------------------------------
 
@@ -188,28 +190,64 @@ void CUtils::FindAllFilesInPaths(const CFileName& search_paths, const CFileName&
 void CUtils::FindAllFiles(const CFileName& path, const CFileName& pattern,
                      std::list<CFileName>& list)
 {
-    CDirectoryEnum penum(path);
+    std::vector<CFileName>              patterns;
+    std::vector< std::list<CFileName> > lists;
+    patterns.push_back(pattern);
 
-    if( penum.StartFindFile("*") == false ) {
-        return;
-    }
+    FindAllFiles(path,patterns,lists);
+
+    list.splice(list.end(),lists[0]);
+}
+
+//------------------------------------------------------------------------------
+
+void CUtils::FindAllFiles(const CFileName& path, const std::vector<CFileName>& patterns,
+                     std::vector< std::list<CFileName> >& lists, bool followlinks)
+{
+    lists.resize(patterns.size());
+
+    DIR* p_dir = opendir(path);
+    if( p_dir == NULL ) return;
+
+    struct dirent* p_ent;
+    while( (p_ent = readdir(p_dir)) != NULL ) {
+        const char* p_name = p_ent->d_name;
+        if( (strcmp(p_name,".") == 0) || (strcmp(p_name,"..") == 0) ) continue;
+
+        CFileName full_name = path / CFileName(p_name);
+
+        // d_type avoids stat for each entry, which is expensive on NFS
+        bool isdir = false;
+        switch(p_ent->d_type){
+            case DT_DIR:
+                isdir = true;
+                break;
+            case DT_REG:
+                break;
+            case DT_LNK:
+                if( followlinks ) isdir = CFileSystem::IsDirectory(full_name);
+                break;
+            default:{
+                    struct stat info;
+                    int ret = followlinks ? stat(full_name,&info) : lstat(full_name,&info);
+                    if( ret == 0 ) isdir = S_ISDIR(info.st_mode);
+                }
+                break;
+        }
+
+        if( isdir ){
+            FindAllFiles(full_name,patterns,lists,followlinks);
+            continue;
+        }
 
-    CFileName file;
-    while( penum.FindFile(file) == true ) {
-        if( file == "." ) continue;
-        if( file == ".." ) continue;
-
-        CFileName full_name = path / file;
-        if( CFileSystem::IsDirectory(full_name) ){
-            FindAllFiles(full_name,pattern,list);
-        } else {
-            if( fnmatch(pattern,file,0) == 0 ){
-                list.push_back(full_name);
+        for(size_t i=0; i < patterns.size(); i++){
+            if( fnmatch(patterns[i],p_name,0) == 0 ){
+                lists[i].push_back(full_name);
             }
         }
     }
 
-    penum.EndFindFile();
+    closedir(p_dir);
 }
 
 //==============================================================================
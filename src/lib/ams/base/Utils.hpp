@@ -28,6 +28,7 @@
 #include <SmallString.hpp>
 #include <FileName.hpp>
 #include <list>
+#include <vector>
 
 //------------------------------------------------------------------------------
 
@@ -62,6 +63,11 @@ public:
     /// find all files in given path
     static void FindAllFiles(const CFileName& path, const CFileName& pattern,
                          std::list<CFileName>& list);
+
+    /// find all files matching patterns in a single pass, lists[i] contains files matching patterns[i]
+    /// symbolic links to directories are followed only if followlinks is true
+    static void FindAllFiles(const CFileName& path, const std::vector<CFileName>& patterns,
+                         std::vector< std::list<CFileName> >& lists, bool followlinks=true);
 };
 
 //------------------------------------------------------------------------------
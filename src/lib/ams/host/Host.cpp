@@ -36,6 +36,7 @@
 #include <UserUtils.hpp>
 #include <Shell.hpp>
 #include <iomanip>
+#include <AMSProfiler.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 
@@ -78,6 +79,8 @@ CHost::CHost(void)
 
 void CHost::InitHostSubSystems(const CFileName& host_subsystems)
 {
+    CAMSProfilerPhase phase("host-subsystems-init");
+
 // global
     HostName    = CShell::GetSystemVariable("HOSTNAME");
 
@@ -239,6 +242,8 @@ long int CHost::CacheValidity(void)
 
 void CHost::InitHost(bool nocache)
 {
+    CAMSProfilerPhase phase("host-init");
+
     // try to load cache
     if( nocache == false) LoadCache();
     CXMLElement* p_cache = HostCache.GetChildElementByPath("cache",true);
@@ -264,10 +269,6 @@ void CHost::InitHost(bool nocache)
         hs->Apply();
     }
 
-    // sort tokens
-    HostTokens.sort();
-    HostTokens.unique();
-
     // save host cache
     if( HostCacheLoaded == false ){
         SaveCache();
@@ -361,41 +362,72 @@ void CHost::SetNumOfHostGPUs(int ngpus)
 
 const CSmallString CHost::GetArchTokens(void)
 {
-    CSmallString tokens;
-
-    std::list<CSmallString>::iterator    it = HostTokens.begin();
-    std::list<CSmallString>::iterator    ie = HostTokens.end();
+    std::list<CSmallString> tokens;
+    for(size_t id=0; id < HostTokens.size(); id++){
+        if( HostTokens[id] ) tokens.push_back(TokenNames[id]);
+    }
+    tokens.sort();
 
-    while(it != ie){
-        if( it != HostTokens.begin() )  tokens << ",";
-        tokens << (*it);
-        it++;
+    CSmallString stokens;
+    for(CSmallString token : tokens){
+        if( stokens != NULL ) stokens << ",";
+        stokens << token;
     }
-    return(tokens);
+    return(stokens);
 }
 
 //------------------------------------------------------------------------------
 
 bool CHost::HasToken(const CSmallString& token)
 {
-    std::list<CSmallString>::iterator    it = HostTokens.begin();
-    std::list<CSmallString>::iterator    ie = HostTokens.end();
+    return( HasToken(GetTokenID(token)) );
+}
 
-    while( it != ie ){
-        if( *it == token ){
-            return(true);
-        }
-        it++;
-    }
+//------------------------------------------------------------------------------
 
-    return(false);
+bool CHost::HasToken(int id)
+{
+    if( (id < 0) || ((size_t)id >= HostTokens.size()) ) return(false);
+    return( HostTokens[id] );
 }
 
 //------------------------------------------------------------------------------
 
 void CHost::AddArchToken(const CSmallString& token)
 {
-    HostTokens.push_back(token);
+    int id = GetTokenID(token,true);
+    if( (size_t)id >= HostTokens.size() ) HostTokens.resize(TokenNames.size(),false);
+    HostTokens[id] = true;
+}
+
+//------------------------------------------------------------------------------
+
+int CHost::GetTokenID(const CSmallString& token,bool create)
+{
+    std::string stoken(token);
+    std::unordered_map<std::string,int>::iterator it = TokenIDs.find(stoken);
+    if( it != TokenIDs.end() ) return(it->second);
+    if( create == false ) return(-1);
+
+    int id = TokenNames.size();
+    TokenNames.push_back(token);
+    TokenIDs[stoken] = id;
+    return(id);
+}
+
+//------------------------------------------------------------------------------
+
+const CSmallString CHost::GetTokenName(int id)
+{
+    if( (id < 0) || ((size_t)id >= TokenNames.size()) ) return("");
+    return(TokenNames[id]);
+}
+
+//------------------------------------------------------------------------------
+
+int CHost::GetNumOfTokenIDs(void)
+{
+    return(TokenNames.size());
 }
 
 //==============================================================================
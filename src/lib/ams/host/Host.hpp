@@ -30,6 +30,9 @@
 #include <SmallString.hpp>
 #include <HostSubSystem.hpp>
 #include <list>
+#include <vector>
+#include <string>
+#include <unordered_map>
 
 //------------------------------------------------------------------------------
 
@@ -92,6 +95,18 @@ public:
     /// has token?
     bool HasToken(const CSmallString& token);
 
+    /// has token with given id?
+    bool HasToken(int id);
+
+    /// get token id from the token dictionary, -1 if unknown and create is false
+    int GetTokenID(const CSmallString& token,bool create=false);
+
+    /// get token name from the token dictionary
+    const CSmallString GetTokenName(int id);
+
+    /// get number of tokens in the token dictionary
+    int GetNumOfTokenIDs(void);
+
     /// set number of CPUs per node
     void SetNumOfHostCPUs(int ncpus);
 
@@ -124,7 +139,11 @@ private:
     int                             NumOfHostCPUs;
     int                             NumOfHostThreads;
     int                             NumOfHostGPUs;
-    std::list<CSmallString>         HostTokens;
+    std::vector<bool>               HostTokens;         // bitset indexed by token id
+
+// token dictionary
+    std::vector<CSmallString>               TokenNames;
+    std::unordered_map<std::string,int>     TokenIDs;
 
     /// load host cache
     void LoadCache(void);
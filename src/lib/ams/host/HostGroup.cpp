@@ -33,6 +33,9 @@
 #include <ModCache.hpp>
 #include <Utils.hpp>
 #include <fnmatch.h>
+#include <AMSProfiler.hpp>
+#include <AMSConfigSnapshot.hpp>
+#include <StatPacket.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 
@@ -60,7 +63,16 @@ CHostGroup::CHostGroup(void)
 
 void CHostGroup::InitHostsConfig(void)
 {
-    HostsConfigFile = AMSRegistry.GetHostsConfigFile();
+    InitHostsConfig(AMSRegistry.GetHostsConfigFile());
+}
+
+//------------------------------------------------------------------------------
+
+void CHostGroup::InitHostsConfig(const CFileName& hosts_config)
+{
+    CAMSProfilerPhase phase("hosts-config-load");
+
+    HostsConfigFile = hosts_config;
 
     if( CFileSystem::IsFile(HostsConfigFile) == false ){
         // no group file
@@ -70,9 +82,7 @@ void CHostGroup::InitHostsConfig(void)
         return;
     }
 
-    CXMLParser xml_parser;
-    xml_parser.SetOutputXMLNode(&HostsConfig);
-    if( xml_parser.Parse(HostsConfigFile) == false ){
+    if( AMSConfigSnapshot.LoadXMLFile(HostsConfigFile,&HostsConfig) == false ){
         ErrorSystem.RemoveAllErrors(); // avoid global error
         CSmallString warning;
         warning << "unable to parse groups config file '" << HostsConfigFile << "'";
@@ -85,6 +95,8 @@ void CHostGroup::InitHostsConfig(void)
 
 void CHostGroup::InitHostGroup(void)
 {
+    CAMSProfilerPhase phase("host-group-init");
+
     HostGroupFile = AMSRegistry.GetHostGroup();
 
     if( CFileSystem::IsFile(HostGroupFile) == false ){
@@ -94,9 +106,7 @@ void CHostGroup::InitHostGroup(void)
         RUNTIME_ERROR(error);
     }
 
-    CXMLParser xml_parser;
-    xml_parser.SetOutputXMLNode(&HostGroup);
-    if( xml_parser.Parse(HostGroupFile) == false ){
+    if( AMSConfigSnapshot.LoadXMLFile(HostGroupFile,&HostGroup) == false ){
         CSmallString error;
         error << "unable to parse host group file '" << HostGroupFile << "'";
         RUNTIME_ERROR(error);
@@ -115,9 +125,7 @@ void CHostGroup::InitAllHostGroups(void)
 
     for(CFileName host_file : host_files){
         CXMLDocument xml_document;
-        CXMLParser xml_parser;
-        xml_parser.SetOutputXMLNode(&xml_document);
-        if( xml_parser.Parse(host_file) == false ){
+        if( AMSConfigSnapshot.LoadXMLFile(host_file,&xml_document) == false ){
             CSmallString error;
             error << "unable to parse host group file '" << host_file << "'";
             RUNTIME_ERROR(error);
@@ -588,11 +596,19 @@ bool CHostGroup::ExecuteStatAction(const CSmallString& action, CStatDatagramSend
             return(false);
         }
 
+        // the compact format must be enabled explicitly, older collectors do not accept it
+        int format = ESF_V1;
+        p_cele->GetAttribute("format",format);
+        if( (format != ESF_V1) && (format != ESF_V2) ){
+            ES_WARNING("unsupported datagram format, using v1");
+            format = ESF_V1;
+        }
+
         CSmallString warning;
         warning << "action '" << laction << "' emmited";
         ES_WARNING(warning);
 
-        return(p_sender->SendDataToServer(server,port));
+        return(p_sender->SendDataToServer(server,port,format));
     }
 
     ES_WARNING("no valid action was found");
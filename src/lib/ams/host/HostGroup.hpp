@@ -45,6 +45,9 @@ public:
     /// init hosts global configuration
     void InitHostsConfig(void);
 
+    /// init hosts global configuration from a given file
+    void InitHostsConfig(const CFileName& hosts_config);
+
     /// init host group
     void InitHostGroup(void);
 
@@ -0,0 +1,366 @@
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <StatDatagramQueue.hpp>
+#include <SoftStat.hpp>
+#include <Shell.hpp>
+#include <UserUtils.hpp>
+#include <fstream>
+#include <sstream>
+#include <map>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//------------------------------------------------------------------------------
+
+// how long the resolved server address is valid (in seconds)
+#define STAT_CACHE_TTL 3600
+
+//------------------------------------------------------------------------------
+
+CStatDatagramQueue StatDatagramQueue;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CStatDatagramQueue::CStatDatagramQueue(void)
+{
+}
+
+//------------------------------------------------------------------------------
+
+CStatDatagramQueue::~CStatDatagramQueue(void)
+{
+    // nothing to do - datagrams must be flushed explicitly by Flush()
+    // the static destruction order of other globals is undefined
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CStatDatagramQueue::AddDatagram(const CSmallString& servername,int port,int format,
+                                     const CAddStatDatagram& datagram)
+{
+    std::string server(servername);
+
+    if( format == ESF_V2 ){
+        // append to the open packet for the same server
+        for(SDatagram& item : Queue){
+            if( (item.Format != ESF_V2) || (item.Data.empty() == false) ) continue;
+            if( (item.Server != server) || (item.Port != port) ) continue;
+            if( item.Packet.AddRecord(datagram) == true ) return;
+            // full - close it
+            item.Data = item.Packet.Finish();
+        }
+        SDatagram item;
+        item.Server = server;
+        item.Port   = port;
+        item.Format = ESF_V2;
+        item.Packet.AddRecord(datagram);
+        Queue.push_back(item);
+        return;
+    }
+
+    SDatagram item;
+    item.Server = server;
+    item.Port   = port;
+    item.Format = ESF_V1;
+    item.Data.assign((const char*)&datagram,sizeof(datagram));
+    Queue.push_back(item);
+}
+
+//------------------------------------------------------------------------------
+
+void CStatDatagramQueue::Flush(void)
+{
+    // statistics are collected on the best effort basis,
+    // thus the method does not report errors via ErrorSystem
+
+    if( Queue.empty() ) return;
+
+    // close open packets
+    for(SDatagram& item : Queue){
+        if( item.Data.empty() ) item.Data = item.Packet.Finish();
+    }
+
+    // send datagrams for servers with cached addresses immediately
+    if( SendDatagrams(false) == true ){
+        Queue.clear();
+        return;
+    }
+
+    // resolve remaining servers in a detached child
+    fflush(NULL);
+    pid_t pid = fork();
+    if( pid < 0 ){
+        // drop datagrams, do not block
+        Queue.clear();
+        return;
+    }
+
+    if( pid == 0 ){
+        // child - detach from the session and the output
+        setsid();
+        if( fork() != 0 ) _exit(0);
+        int fd = open("/dev/null",O_RDWR);
+        if( fd >= 0 ){
+            dup2(fd,STDIN_FILENO);
+            dup2(fd,STDOUT_FILENO);
+            dup2(fd,STDERR_FILENO);
+            if( fd > STDERR_FILENO ) close(fd);
+        }
+        SendDatagrams(true);
+        _exit(0);
+    }
+
+    // parent - the first child terminates immediately
+    waitpid(pid,NULL,0);
+    Queue.clear();
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatDatagramQueue::SendDatagrams(bool resolve)
+{
+    std::map<std::string,uint32_t>  addrs;
+    bool                            all = true;
+
+    std::list<SDatagram>::iterator it = Queue.begin();
+    while( it != Queue.end() ){
+        // resolve server only once per flush
+        std::map<std::string,uint32_t>::iterator ait = addrs.find(it->Server);
+        if( ait == addrs.end() ){
+            uint32_t addr = 0;
+            bool     found = GetCachedAddress(it->Server,addr);
+            if( (found == false) && (resolve == true) ){
+                found = ResolveAddress(it->Server,addr);
+            }
+            if( found == false ){
+                // keep it in the queue
+                all = false;
+                it++;
+                continue;
+            }
+            ait = addrs.insert(std::make_pair(it->Server,addr)).first;
+        }
+        SendDatagram(ait->second,it->Port,it->Data);
+        it = Queue.erase(it);
+    }
+
+    return(all);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatDatagramQueue::SendDatagram(uint32_t addr,int port,const std::string& data)
+{
+    sockaddr_in server_addr;
+    memset(&server_addr,0,sizeof(server_addr));
+    server_addr.sin_family      = AF_INET;
+    server_addr.sin_port        = htons(port);
+    server_addr.sin_addr.s_addr = addr;
+
+    int sfd = socket(AF_INET,SOCK_DGRAM,0);
+    if( sfd == -1 ) return(false);
+
+    // UDP send does not wait on the server, MSG_DONTWAIT guards a full socket buffer
+    ssize_t ret = sendto(sfd,data.data(),data.size(),MSG_NOSIGNAL|MSG_DONTWAIT,
+                         (sockaddr*)&server_addr,sizeof(server_addr));
+    close(sfd);
+
+    return(ret == (ssize_t)data.size());
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+const CFileName CStatDatagramQueue::GetDefaultStatCacheName(void)
+{
+    CFileName stat_cache = CShell::GetSystemVariable("AMS_STAT_CACHE");
+    if( stat_cache != NULL ) return(stat_cache);
+
+    CFileName stat_cache_dir = CShell::GetSystemVariable("AMS_HOST_CACHE_DIR");
+    if( stat_cache_dir == NULL ){
+        stat_cache_dir = "/tmp";
+    }
+    stat_cache_dir = stat_cache_dir / "ams_stat_r09." + CUserUtils::GetUserName();
+    stat_cache = stat_cache_dir / "servers";
+    return(stat_cache);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatDatagramQueue::GetStatCacheName(CFileName& cache_name)
+{
+    cache_name = GetDefaultStatCacheName();
+    if( CShell::GetSystemVariable("AMS_STAT_CACHE") != NULL ) return(true);
+
+    // the cache decides where the statistics are sent - it must not be shared with others
+    return( PrepareCacheDir(cache_name.GetFileDirectory()) );
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatDatagramQueue::PrepareCacheDir(const CFileName& dir)
+{
+    mkdir(dir,0700);
+
+    struct stat info;
+    if( lstat(dir,&info) != 0 ) return(false);
+    if( S_ISDIR(info.st_mode) == false ) return(false);
+    if( info.st_uid != getuid() ) return(false);
+    if( (info.st_mode & (S_IWGRP | S_IWOTH)) != 0 ) return(false);
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatDatagramQueue::ReadCache(const CFileName& cache_name,std::string& content)
+{
+    content.clear();
+
+    int fd = open(cache_name,O_RDONLY|O_NOFOLLOW);
+    if( fd < 0 ) return(false);
+
+    struct stat info;
+    if( (fstat(fd,&info) != 0) || (S_ISREG(info.st_mode) == false) ||
+        (info.st_uid != getuid()) || ((info.st_mode & (S_IWGRP | S_IWOTH)) != 0) ){
+        close(fd);
+        return(false);
+    }
+
+    char    buffer[4096];
+    ssize_t len;
+    while( (len = read(fd,buffer,sizeof(buffer))) > 0 ){
+        content.append(buffer,len);
+    }
+    close(fd);
+
+    return(len == 0);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatDatagramQueue::GetCachedAddress(const std::string& server,uint32_t& addr)
+{
+    // numeric address does not need any resolution
+    in_addr iaddr;
+    if( inet_aton(server.c_str(),&iaddr) != 0 ){
+        addr = iaddr.s_addr;
+        return(true);
+    }
+
+    // cache format: server address time
+    CFileName   cache_name;
+    std::string content;
+    if( GetStatCacheName(cache_name) == false ) return(false);
+    if( ReadCache(cache_name,content) == false ) return(false);
+
+    std::stringstream   ifs(content);
+    std::string         line;
+    time_t              now = time(NULL);
+
+    while( getline(ifs,line) ){
+        std::stringstream   str(line);
+        std::string         lserver,laddr;
+        long long           ltime = 0;
+        str >> lserver >> laddr >> ltime;
+        if( (str.fail() == true) || (lserver != server) ) continue;
+        if( (ltime > (long long)now) || (now - ltime > STAT_CACHE_TTL) ) return(false);
+        if( inet_aton(laddr.c_str(),&iaddr) == 0 ) return(false);
+        addr = iaddr.s_addr;
+        return(true);
+    }
+
+    return(false);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatDatagramQueue::ResolveAddress(const std::string& server,uint32_t& addr)
+{
+    addrinfo    hints;
+    addrinfo*   p_addrinfo = NULL;
+
+    memset(&hints,0,sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    if( getaddrinfo(server.c_str(),NULL,&hints,&p_addrinfo) != 0 ) return(false);
+    if( p_addrinfo == NULL ) return(false);
+
+    addr = ((sockaddr_in*)p_addrinfo->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(p_addrinfo);
+
+    // update the cache - keep other servers, replace the file atomically
+    CFileName cache_name;
+    if( GetStatCacheName(cache_name) == false ) return(true);
+
+    std::string         old_content;
+    std::stringstream   content;
+    std::string         line;
+
+    ReadCache(cache_name,old_content);
+    std::stringstream   ifs(old_content);
+
+    while( getline(ifs,line) ){
+        std::stringstream   str(line);
+        std::string         lserver;
+        str >> lserver;
+        if( (lserver.empty() == true) || (lserver == server) ) continue;
+        content << line << std::endl;
+    }
+
+    in_addr iaddr;
+    iaddr.s_addr = addr;
+    content << server << " " << inet_ntoa(iaddr) << " " << (long long)time(NULL) << std::endl;
+
+    // mkstemp creates a new file with 0600 permissions, it never follows symlinks
+    std::string tmp_name = std::string(cache_name) + ".XXXXXX";
+    int fd = mkstemp(&tmp_name[0]);
+    if( fd < 0 ) return(true);
+
+    std::string data = content.str();
+    bool        ok = write(fd,data.data(),data.size()) == (ssize_t)data.size();
+    ok &= close(fd) == 0;
+    if( (ok == false) || (rename(tmp_name.c_str(),cache_name) != 0) ){
+        unlink(tmp_name.c_str());
+    }
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,103 @@
+#ifndef StatDatagramQueueH
+#define StatDatagramQueueH
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <SmallString.hpp>
+#include <FileName.hpp>
+#include <StatPacket.hpp>
+#include <string>
+#include <list>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+class CAddStatDatagram;
+
+//------------------------------------------------------------------------------
+
+/// queue of statistics datagrams
+/// datagrams are collected during the command and flushed by Flush() in Finalize,
+/// the server address is resolved only once and cached on disk (AMS_STAT_CACHE)
+/// in a private directory of the user,
+/// if the address is not cached the datagrams are sent by a detached child,
+/// thus the module loading never waits on DNS or on the network
+/// records for the v2 format are packed into as few packets as possible
+
+class AMS_PACKAGE CStatDatagramQueue {
+public:
+// constructor and destructor --------------------------------------------------
+    CStatDatagramQueue(void);
+    ~CStatDatagramQueue(void);
+
+// executive methods -----------------------------------------------------------
+    /// add datagram to the queue, format is EStatFormat
+    void AddDatagram(const CSmallString& servername,int port,int format,
+                     const CAddStatDatagram& datagram);
+
+    /// send all queued datagrams
+    void Flush(void);
+
+// information methods ---------------------------------------------------------
+    /// get name of the server address cache
+    static const CFileName GetDefaultStatCacheName(void);
+
+    /// get name of the server address cache in the private directory, false if it is not safe to use
+    static bool GetStatCacheName(CFileName& cache_name);
+
+// section of private data -----------------------------------------------------
+private:
+    struct SDatagram {
+        std::string     Server;
+        int             Port;
+        int             Format;
+        std::string     Data;       // finished packet
+        CStatPacket     Packet;     // open v2 packet
+    };
+    std::list<SDatagram>    Queue;
+
+    /// send datagrams to resolved servers, returns true if all servers were resolved
+    bool SendDatagrams(bool resolve);
+
+    /// send datagram to IPv4 address in the network byte order
+    static bool SendDatagram(uint32_t addr,int port,const std::string& data);
+
+    /// get cached address of the server
+    static bool GetCachedAddress(const std::string& server,uint32_t& addr);
+
+    /// resolve server and update the cache
+    static bool ResolveAddress(const std::string& server,uint32_t& addr);
+
+    /// read the cache if it is owned by the user and not writable by others
+    static bool ReadCache(const CFileName& cache_name,std::string& content);
+
+    /// is the cache directory private for the current user?
+    static bool PrepareCacheDir(const CFileName& dir);
+};
+
+//------------------------------------------------------------------------------
+
+extern AMS_PACKAGE CStatDatagramQueue StatDatagramQueue;
+
+//------------------------------------------------------------------------------
+
+#endif
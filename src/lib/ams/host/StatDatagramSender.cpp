@@ -25,7 +25,7 @@
 //------------------------------------------------------------------------------
 //==============================================================================
 
-bool CStatDatagramSender::SendDataToServer(const CSmallString& servername,int port)
+bool CStatDatagramSender::SendDataToServer(const CSmallString& servername,int port,int format)
 {
     return(false);
 }
@@ -28,8 +28,8 @@
 
 class CStatDatagramSender {
 public:
-    /// send datagram
-    virtual bool SendDataToServer(const CSmallString& servername,int port);
+    /// send datagram in the given wire format (EStatFormat)
+    virtual bool SendDataToServer(const CSmallString& servername,int port,int format);
 
     /// get datagram flags
     virtual int GetFlags(void);
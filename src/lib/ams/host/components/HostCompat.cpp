@@ -27,14 +27,11 @@
 #include <Utils.hpp>
 #include <Host.hpp>
 #include <ErrorSystem.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/classification.hpp>
+#include <vector>
 
 //------------------------------------------------------------------------------
 
 using namespace std;
-using namespace boost;
-using namespace boost::algorithm;
 
 //==============================================================================
 //------------------------------------------------------------------------------
@@ -62,34 +59,33 @@ void CHostSubSystemCompat::Apply(void)
         INVALID_ARGUMENT("config element 'compat' is NULL");
     }
 
-    string stokens = string(Host.GetArchTokens());
-    std::list<string> tokens;
-
-    split(tokens,stokens,is_any_of(","));
-
-    // add all compatibility tokens to ArchTokens
-    std::list<string>::iterator it = tokens.begin();
-    std::list<string>::iterator ie = tokens.end();
-    while( it != ie ){
-        CXMLElement* p_arch = p_ele->GetFirstChildElement("arch");
-        while( p_arch ){
-            string arch_name;
-            p_arch->GetAttribute("name",arch_name);
-            if( arch_name == (*it) ){
-                // add all compatible roots into the hosts tokens
-                CXMLElement* p_nele = p_arch->GetFirstChildElement("nextmatch");
-                while( p_nele ){
-                    CSmallString narch;
-                    p_nele->GetAttribute("name",narch);
-                    ArchTokens.push_back(narch);
-                    p_nele = p_nele->GetNextSiblingElement("nextmatch");
-                }
+    // closure table: arch token id -> ids of compatible tokens
+    std::vector< std::vector<int> > closure(Host.GetNumOfTokenIDs());
+
+    CXMLElement* p_arch = p_ele->GetFirstChildElement("arch");
+    while( p_arch ){
+        CSmallString arch_name;
+        p_arch->GetAttribute("name",arch_name);
+        // only tokens provided by the host are expanded
+        int id = Host.GetTokenID(arch_name);
+        if( Host.HasToken(id) ){
+            CXMLElement* p_nele = p_arch->GetFirstChildElement("nextmatch");
+            while( p_nele ){
+                CSmallString narch;
+                p_nele->GetAttribute("name",narch);
+                closure[id].push_back(Host.GetTokenID(narch,true));
+                p_nele = p_nele->GetNextSiblingElement("nextmatch");
             }
-            p_arch = p_arch->GetNextSiblingElement("arch");
         }
-        it++;
+        p_arch = p_arch->GetNextSiblingElement("arch");
     }
 
+    // add all compatibility tokens to ArchTokens
+    for(const std::vector<int>& nids : closure){
+        for(int nid : nids){
+            ArchTokens.push_back(Host.GetTokenName(nid));
+        }
+    }
 
     for(CSmallString token : ArchTokens){
         Host.AddArchToken(token);
@@ -20,7 +20,7 @@
 // =============================================================================
 
 #include <HostSubSystem.hpp>
-#include <XMLParser.hpp>
+#include <AMSConfigSnapshot.hpp>
 #include <ErrorSystem.hpp>
 #include <FileSystem.hpp>
 
@@ -40,15 +40,8 @@
 
 CHostSubSystem::CHostSubSystem(const CFileName& config_file)
 {
+    // config is loaded by Create()
     ConfigFile = config_file;
-    CXMLParser xml_parser;
-    xml_parser.SetOutputXMLNode(&Config);
-
-    if( xml_parser.Parse(ConfigFile) == false ) {
-        CSmallString    error;
-        error << "unable to load '" << ConfigFile << "'";
-        RUNTIME_ERROR(error);
-    }
 }
 
 //------------------------------------------------------------------------------
@@ -68,10 +61,8 @@ CHostSubSystemPtr CHostSubSystem::Create(const CFileName& file_name)
         RUNTIME_ERROR(error);
     }
 
-    CXMLParser      xml_parser;
     CXMLDocument    xml_config;
-    xml_parser.SetOutputXMLNode(&xml_config);
-    if( xml_parser.Parse(file_name) == false ){
+    if( AMSConfigSnapshot.LoadXMLFile(file_name,&xml_config) == false ){
         CSmallString error;
         error << "unable to parse host subsystem file '" << file_name << "'";
         RUNTIME_ERROR(error);
@@ -109,6 +100,13 @@ CHostSubSystemPtr CHostSubSystem::Create(const CFileName& file_name)
         RUNTIME_ERROR(error);
     }
 
+    // move the already parsed config into the subsystem
+    if( p_ele->DuplicateNode(&sub_module->Config) == NULL ){
+        CSmallString error;
+        error << "unable to copy config of host subsystem '" << file_name << "'";
+        RUNTIME_ERROR(error);
+    }
+
     return(sub_module);
 }
 
@@ -0,0 +1,312 @@
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <ActivationCache.hpp>
+#include <ErrorSystem.hpp>
+#include <XMLDocument.hpp>
+#include <XMLElement.hpp>
+#include <XMLParser.hpp>
+#include <XMLPrinter.hpp>
+#include <ShellProcessor.hpp>
+#include <ModuleController.hpp>
+#include <SiteController.hpp>
+#include <Module.hpp>
+#include <Host.hpp>
+#include <HostGroup.hpp>
+#include <AMSRegistry.hpp>
+#include <User.hpp>
+#include <UserUtils.hpp>
+#include <Shell.hpp>
+#include <sha1.hpp>
+#include <sstream>
+
+#include <unistd.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+
+// increase when the entry format or the key changes
+#define ACTIVATION_CACHE_VERSION "r09.1"
+
+//------------------------------------------------------------------------------
+
+CActivationCache ActivationCache;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CActivationCache::CActivationCache(void)
+{
+    Enabled = false;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CActivationCache::InitKey(const CSmallString& action,const std::list<CSmallString>& modules,bool do_not_export)
+{
+    Enabled = false;
+    Key.clear();
+    KeyItems.clear();
+    CacheDir = NULL;
+    Builds.clear();
+
+    CSmallString setup = CShell::GetSystemVariable("AMS_ACTIVATION_CACHE");
+    if( setup == "no" ) return;
+    if( (setup != "yes") && (SiteController.IsBatchJob() == false) ) return;
+
+    CacheDir = GetCacheDir();
+    if( PrepareCacheDir(CacheDir) == false ) return;
+
+    Enabled = true;
+
+    std::stringstream res;
+    res << Host.GetNCPUs() << "/" << Host.GetNumOfHostCPUs() << ";";
+    res << Host.GetNGPUs() << "/" << Host.GetNumOfHostGPUs() << ";";
+    res << Host.GetNNodes();
+
+    std::stringstream flags;
+    flags << Module.GetFlags() << ";" << do_not_export;
+
+    // everything the build resolution and the shell actions depend on
+    AddKeyItem("version",ACTIVATION_CACHE_VERSION);
+    AddKeyItem("bundles",ModuleController.GetBundlesSignature());
+    AddKeyItem("site",SiteController.GetActiveSite());
+    AddKeyItem("hostgroup",HostGroup.GetHostGroupNickName());
+    AddFileKeyItem("hostsconfig",AMSRegistry.GetHostsConfigFile());
+    AddFileKeyItem("hostgroupfile",HostGroup.GetHostGroupFile());
+    AddKeyItem("tokens",Host.GetArchTokens());
+    AddKeyItem("resources",res.str().c_str());
+    AddKeyItem("user",User.GetName());
+    AddKeyItem("groups",User.GetACLGroups());
+    AddKeyItem("flags",flags.str().c_str());
+    AddKeyItem("active",CShell::GetSystemVariable("AMS_ACTIVE_MODULES"));
+    AddKeyItem("exported",CShell::GetSystemVariable("AMS_EXPORTED_MODULES"));
+    AddKeyItem("action",action);
+    for(const CSmallString& module : modules){
+        AddKeyItem("module",module);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CActivationCache::AddKeyItem(const CSmallString& name,const CSmallString& value)
+{
+    if( Enabled == false ) return;
+
+    std::string item = std::string(name) + "=";
+    if( value != NULL ) item += std::string(value);
+    KeyItems.push_back(item);
+    Key += item + "\n";
+}
+
+//------------------------------------------------------------------------------
+
+void CActivationCache::AddFileKeyItem(const CSmallString& name,const CFileName& file)
+{
+    std::stringstream signature;
+    signature << (const char*)file;
+
+    struct stat info;
+    if( (file != NULL) && (stat(file,&info) == 0) ){
+        signature << ":" << info.st_ino << ":" << info.st_size
+                  << ":" << info.st_mtim.tv_sec << "." << info.st_mtim.tv_nsec;
+    } else {
+        signature << ":-";
+    }
+
+    AddKeyItem(name,signature.str().c_str());
+}
+
+//------------------------------------------------------------------------------
+
+const CFileName CActivationCache::GetEntryName(void) const
+{
+    CFileName entry_name = CacheDir / sha1(Key).c_str();
+    entry_name = entry_name + ".xml";
+    return(entry_name);
+}
+
+//------------------------------------------------------------------------------
+
+bool CActivationCache::IsEnabled(void) const
+{
+    return(Enabled);
+}
+
+//------------------------------------------------------------------------------
+
+const CFileName CActivationCache::GetCacheDir(void)
+{
+    CFileName cache_dir = CShell::GetSystemVariable("AMS_ACTIVATION_CACHE_DIR");
+    if( cache_dir != NULL ) return(cache_dir);
+
+    cache_dir = CShell::GetSystemVariable("AMS_HOST_CACHE_DIR");
+    if( cache_dir == NULL ){
+        cache_dir = "/tmp";
+    }
+    cache_dir = cache_dir / "ams_act_r09." + CUserUtils::GetUserName();
+    return(cache_dir);
+}
+
+//------------------------------------------------------------------------------
+
+bool CActivationCache::PrepareCacheDir(const CFileName& dir)
+{
+    // the entries are replayed into the shell - the directory must not be writable by others
+    mkdir(dir,0700);
+
+    struct stat info;
+    if( lstat(dir,&info) != 0 ) return(false);
+    if( S_ISDIR(info.st_mode) == false ) return(false);
+    if( info.st_uid != getuid() ) return(false);
+    if( (info.st_mode & (S_IWGRP | S_IWOTH)) != 0 ) return(false);
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CActivationCache::ReplayActivation(CVerboseStr& vout)
+{
+    if( Enabled == false ) return(false);
+
+    CXMLDocument    entry;
+    CXMLParser      xml_parser;
+    xml_parser.SetOutputXMLNode(&entry);
+    xml_parser.EnableWhiteCharacters(false);
+
+    CFileName entry_name = GetEntryName();
+    if( access(entry_name,R_OK) != 0 ) return(false);
+    if( xml_parser.Parse(entry_name) == false ){
+        ES_WARNING("unable to parse activation cache entry, ignoring it");
+        return(false);
+    }
+
+    CXMLElement* p_aele = entry.GetFirstChildElement("activation");
+    if( p_aele == NULL ) return(false);
+
+    // validate the key, the entry name is only its hash
+    std::string  key;
+    CXMLElement* p_kele = p_aele->GetChildElementByPath("key/item");
+    while( p_kele != NULL ){
+        CSmallString item;
+        p_kele->GetAttribute("value",item);
+        key += std::string(item) + "\n";
+        p_kele = p_kele->GetNextSiblingElement("item");
+    }
+    if( key != Key ) return(false);
+
+    CXMLElement* p_actions = p_aele->GetFirstChildElement("actions");
+    if( p_actions == NULL ) return(false);
+
+    ShellProcessor.RestoreActions(p_actions);
+
+    // builds - statistics and print
+    CXMLElement* p_bele = p_aele->GetChildElementByPath("builds/build");
+    while( p_bele != NULL ){
+        CSmallString build,bundle;
+        p_bele->GetAttribute("name",build);
+        p_bele->GetAttribute("bundle",bundle);
+        vout << "           Loaded module : " << build << " (cached)" << std::endl;
+        Module.EmitAddAction(build,bundle);
+        p_bele = p_bele->GetNextSiblingElement("build");
+    }
+
+    // the entry is up-to-date
+    Enabled = false;
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+void CActivationCache::AddBuild(const CSmallString& build,const CSmallString& bundle)
+{
+    if( Enabled == false ) return;
+
+    SBuild rec;
+    rec.Build  = build;
+    rec.Bundle = bundle;
+    Builds.push_back(rec);
+}
+
+//------------------------------------------------------------------------------
+
+bool CActivationCache::SaveActivation(void)
+{
+    if( Enabled == false ) return(false);
+
+    CXMLDocument entry;
+    entry.CreateChildDeclaration();
+
+    CXMLElement* p_aele = entry.CreateChildElement("activation");
+
+    CXMLElement* p_kele = p_aele->CreateChildElement("key");
+    for(const std::string& item : KeyItems){
+        CXMLElement* p_iele = p_kele->CreateChildElement("item");
+        p_iele->SetAttribute("value",item.c_str());
+    }
+
+    CXMLElement* p_bsele = p_aele->CreateChildElement("builds");
+    for(const SBuild& rec : Builds){
+        CXMLElement* p_bele = p_bsele->CreateChildElement("build");
+        p_bele->SetAttribute("name",rec.Build);
+        p_bele->SetAttribute("bundle",rec.Bundle);
+    }
+
+    CXMLElement* p_actions = p_aele->CreateChildElement("actions");
+    ShellProcessor.SaveActions(p_actions);
+
+    // replace the entry atomically, concurrent jobs can write the same entry
+    // even from different hosts sharing the cache directory
+    char hostname[256];
+    if( gethostname(hostname,sizeof(hostname)) != 0 ) hostname[0] = '\0';
+    hostname[sizeof(hostname)-1] = '\0';
+
+    CFileName         entry_name = GetEntryName();
+    std::stringstream tmp_name;
+    tmp_name << (const char*)entry_name << "." << hostname << "." << getpid();
+
+    CXMLPrinter xml_printer;
+    xml_printer.SetPrintedXMLNode(&entry);
+    if( xml_printer.Print(CFileName(tmp_name.str().c_str())) == false ){
+        unlink(tmp_name.str().c_str());
+        ES_WARNING("unable to save activation cache entry");
+        return(false);
+    }
+    if( rename(tmp_name.str().c_str(),entry_name) != 0 ){
+        unlink(tmp_name.str().c_str());
+        ES_WARNING("unable to save activation cache entry");
+        return(false);
+    }
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,99 @@
+#ifndef ActivationCacheH
+#define ActivationCacheH
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <SmallString.hpp>
+#include <FileName.hpp>
+#include <VerboseStr.hpp>
+#include <string>
+#include <list>
+
+//------------------------------------------------------------------------------
+
+/// cache of module activations and batch job site inits
+/// the key contains everything the build resolution depends on (bundle caches,
+/// host tokens and resources, user ACL groups, flags, active modules, and
+/// requested modules), the entry stores the resolved builds and shell actions
+/// entries are stored in AMS_ACTIVATION_CACHE_DIR or in AMS_HOST_CACHE_DIR
+/// the cache is used in batch jobs by default, AMS_ACTIVATION_CACHE=yes/no
+/// overrides it
+
+class AMS_PACKAGE CActivationCache {
+public:
+// constructor -----------------------------------------------------------------
+    CActivationCache(void);
+
+// setup methods ---------------------------------------------------------------
+    /// init key for requested modules, it must be called after host, user, site, and module controller init
+    void InitKey(const CSmallString& action,const std::list<CSmallString>& modules,bool do_not_export);
+
+    /// add additional item to the key
+    void AddKeyItem(const CSmallString& name,const CSmallString& value);
+
+    /// add signature of the file (inode, size, and mtime) to the key
+    void AddFileKeyItem(const CSmallString& name,const CFileName& file);
+
+// executive methods -----------------------------------------------------------
+    /// restore shell actions and replay statistics from the cache
+    bool ReplayActivation(CVerboseStr& vout);
+
+    /// record resolved build
+    void AddBuild(const CSmallString& build,const CSmallString& bundle);
+
+    /// save current shell actions and resolved builds
+    bool SaveActivation(void);
+
+// information methods ---------------------------------------------------------
+    /// is cache enabled?
+    bool IsEnabled(void) const;
+
+    /// get cache directory
+    static const CFileName GetCacheDir(void);
+
+// section of private data -----------------------------------------------------
+private:
+    struct SBuild {
+        CSmallString    Build;
+        CSmallString    Bundle;
+    };
+
+    bool                    Enabled;
+    std::string             Key;
+    std::list<std::string>  KeyItems;
+    CFileName               CacheDir;
+    std::list<SBuild>       Builds;
+
+    /// get name of the entry - the hash of the key
+    const CFileName GetEntryName(void) const;
+
+    /// is the cache directory private for the current user?
+    static bool PrepareCacheDir(const CFileName& dir);
+};
+
+//------------------------------------------------------------------------------
+
+extern CActivationCache ActivationCache;
+
+//------------------------------------------------------------------------------
+
+#endif
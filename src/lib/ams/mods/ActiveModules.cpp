@@ -0,0 +1,205 @@
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2012 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//     Copyright (C) 2011 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//     Copyright (C) 2004,2005,2008,2010 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <ActiveModules.hpp>
+#include <ModUtils.hpp>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+using namespace boost;
+using namespace boost::algorithm;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CActiveModule::CActiveModule(const CSmallString& module)
+{
+    Spec = module;
+    CModUtils::ParseModuleName(module,Name,Ver,Arch,Mode);
+}
+
+//------------------------------------------------------------------------------
+
+bool CActiveModule::Matches(const CSmallString& ver,const CSmallString& arch,
+                            const CSmallString& mode) const
+{
+    if( ver == NULL ) return(true);
+    if( Ver != ver ) return(false);
+    if( arch == NULL ) return(true);
+    if( Arch != arch ) return(false);
+    if( mode == NULL ) return(true);
+    return( Mode == mode );
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CActiveModules::CActiveModules(void)
+{
+    Changed = false;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CActiveModules::Parse(const CSmallString& modules)
+{
+    Records.clear();
+    NameIndex.clear();
+    Changed = false;
+
+    std::string smodules = std::string(modules);
+    if( smodules.empty() ) return;
+
+    std::list<std::string> items;
+    split(items,smodules,is_any_of("|"),boost::token_compress_on);
+
+    for(std::string item : items){
+        if( item.empty() ) continue;
+        AddRecord(item);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+const CSmallString CActiveModules::Serialize(void) const
+{
+    CSmallString    mods;
+    bool            first = true;
+    for(const CActiveModule& rec : Records){
+        if( ! first ) mods << "|";
+        mods << rec.Spec;
+        first = false;
+    }
+    return(mods);
+}
+
+//------------------------------------------------------------------------------
+
+void CActiveModules::Update(const CSmallString& module,EModuleAction action)
+{
+    if( module == NULL ) return;
+
+    RemoveRecord(module);
+    if( action == EMA_ADD_MODULE ) AddRecord(module);
+    Changed = true;
+}
+
+//------------------------------------------------------------------------------
+
+bool CActiveModules::IsChanged(void) const
+{
+    return(Changed);
+}
+
+//------------------------------------------------------------------------------
+
+void CActiveModules::AddRecord(const CSmallString& module)
+{
+    TRecords::iterator it = Records.insert(Records.end(),CActiveModule(module));
+    // multimap inserts equal keys at the end of their range
+    NameIndex.insert(TNameIndex::value_type(it->Name,it));
+}
+
+//------------------------------------------------------------------------------
+
+void CActiveModules::RemoveRecord(const CSmallString& module)
+{
+    CSmallString name = CModUtils::GetModuleName(module);
+
+    std::pair<TNameIndex::iterator,TNameIndex::iterator> range = NameIndex.equal_range(name);
+    TNameIndex::iterator it = range.first;
+    while( it != range.second ){
+        if( it->second->Spec == module ){
+            Records.erase(it->second);
+            it = NameIndex.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+const CActiveModule* CActiveModules::Find(const CSmallString& module) const
+{
+    CSmallString name,ver,arch,mode;
+    CModUtils::ParseModuleName(module,name,ver,arch,mode);
+
+    std::pair<TNameIndex::const_iterator,TNameIndex::const_iterator> range = NameIndex.equal_range(name);
+    for(TNameIndex::const_iterator it = range.first; it != range.second; it++){
+        if( it->second->Matches(ver,arch,mode) ) return( &(*it->second) );
+    }
+
+    return(NULL);
+}
+
+//------------------------------------------------------------------------------
+
+const CActiveModule* CActiveModules::FindByName(const CSmallString& name) const
+{
+    TNameIndex::const_iterator it = NameIndex.lower_bound(name);
+    if( (it == NameIndex.end()) || (it->first != name) ) return(NULL);
+    return( &(*it->second) );
+}
+
+//------------------------------------------------------------------------------
+
+void CActiveModules::GetSpecifications(std::list<CSmallString>& modules) const
+{
+    for(const CActiveModule& rec : Records){
+        modules.push_back(rec.Spec);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+int CActiveModules::GetMaxSpecLength(void) const
+{
+    int maxlen = 0;
+    for(const CActiveModule& rec : Records){
+        int len = rec.Spec.GetLength();
+        if( len > maxlen ) maxlen = len;
+    }
+    return(maxlen);
+}
+
+//------------------------------------------------------------------------------
+
+size_t CActiveModules::GetNumberOfModules(void) const
+{
+    return(Records.size());
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,106 @@
+#ifndef ActiveModulesH
+#define ActiveModulesH
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2012 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//     Copyright (C) 2011 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//     Copyright (C) 2004,2005,2008,2010 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <SmallString.hpp>
+#include <ShellProcessor.hpp>
+#include <list>
+#include <map>
+
+//------------------------------------------------------------------------------
+
+/// parsed record of active or exported module
+class AMS_PACKAGE CActiveModule {
+public:
+// constructor -----------------------------------------------------------------
+    CActiveModule(const CSmallString& module);
+
+// section of public data ------------------------------------------------------
+    CSmallString    Spec;       // specification as stored in the environment
+    CSmallString    Name;
+    CSmallString    Ver;
+    CSmallString    Arch;
+    CSmallString    Mode;
+
+    /// does the record match incomplete module specification name[:ver[:arch[:mode]]]
+    bool Matches(const CSmallString& ver,const CSmallString& arch,const CSmallString& mode) const;
+};
+
+//------------------------------------------------------------------------------
+
+/// ordered list of active or exported modules indexed by module names
+class AMS_PACKAGE CActiveModules {
+public:
+// constructor -----------------------------------------------------------------
+    CActiveModules(void);
+
+// setup methods ---------------------------------------------------------------
+    /// parse list of modules separated by "|"
+    void Parse(const CSmallString& modules);
+
+    /// serialize list of modules into a string separated by "|"
+    const CSmallString Serialize(void) const;
+
+    /// add or remove module specification
+    void Update(const CSmallString& module,EModuleAction action);
+
+    /// was the list changed since it was parsed?
+    bool IsChanged(void) const;
+
+// queries ---------------------------------------------------------------------
+    /// find the first record matching name[:ver[:arch[:mode]]], NULL if not found
+    const CActiveModule* Find(const CSmallString& module) const;
+
+    /// find the first record with a given module name, NULL if not found
+    const CActiveModule* FindByName(const CSmallString& name) const;
+
+    /// return module specifications in the activation order
+    void GetSpecifications(std::list<CSmallString>& modules) const;
+
+    /// return length of the longest module specification
+    int GetMaxSpecLength(void) const;
+
+    /// return number of modules
+    size_t GetNumberOfModules(void) const;
+
+// section of private data -----------------------------------------------------
+private:
+    typedef std::list<CActiveModule>                    TRecords;
+    typedef std::multimap<CSmallString,TRecords::iterator>  TNameIndex;
+
+    TRecords    Records;        // modules in the activation order
+    TNameIndex  NameIndex;      // records indexed by module names, equal keys keep activation order
+    bool        Changed;
+
+    /// add new record at the end of list
+    void AddRecord(const CSmallString& module);
+
+    /// remove record with exactly the same specification
+    void RemoveRecord(const CSmallString& module);
+};
+
+//------------------------------------------------------------------------------
+
+#endif
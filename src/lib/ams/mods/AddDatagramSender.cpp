@@ -20,18 +20,7 @@
 // =============================================================================
 
 #include <AddDatagramSender.hpp>
-#include <ErrorSystem.hpp>
-
-#include <unistd.h>
-#include <string.h>
-#include <sys/socket.h>
-#include <netdb.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-
-//------------------------------------------------------------------------------
-
-#define MAX_NET_NAME 255
+#include <StatDatagramQueue.hpp>
 
 //==============================================================================
 //------------------------------------------------------------------------------
@@ -44,83 +33,10 @@ int CAddDatagramSender::GetFlags(void)
 
 //------------------------------------------------------------------------------
 
-bool CAddDatagramSender::SendDataToServer(const CSmallString& servername,int port)
+bool CAddDatagramSender::SendDataToServer(const CSmallString& servername,int port,int format)
 {
-    // get IP address of server ---------------------
-    addrinfo*      p_addrinfo;
-    int            nerr;
-
-    // get hostname and IP
-    if( (nerr = getaddrinfo(servername,NULL,NULL,&p_addrinfo)) != 0 ) {
-        CSmallString error;
-        error << "unable to decode server name '" << servername
-              << "' (" <<  gai_strerror(nerr) << ")";
-        ES_WARNING(error);
-        return(false);
-    }
-
-    // get server name
-    char s_name[MAX_NET_NAME];
-    memset(s_name,0,MAX_NET_NAME);
-
-    if( (nerr = getnameinfo(p_addrinfo->ai_addr,p_addrinfo->ai_addrlen,s_name,
-                            MAX_NET_NAME-1,NULL,0,0)) != 0 ) {
-        CSmallString error;
-        error << "unable to get server name (" <<  gai_strerror(nerr) << ")";
-        ES_WARNING(error);
-        return(false);
-    }
-    CSmallString name = s_name;
-
-    // get server IP
-    if( (nerr = getnameinfo(p_addrinfo->ai_addr,p_addrinfo->ai_addrlen,s_name,
-                            MAX_NET_NAME-1,NULL,0,NI_NUMERICHOST)) != 0 ) {
-        CSmallString error;
-        error << "unable to get server IP (" <<  gai_strerror(nerr) << ")";
-        ES_WARNING(error);
-        return(false);
-    }
-    CSmallString ip = s_name;
-
-    freeaddrinfo(p_addrinfo);
-
-    // Obtain address(es) matching host/port
-    sockaddr_in    server_addr;
-
-    server_addr.sin_port = htons(port);
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = inet_addr(ip);
-
-    int sfd;
-
-    sfd = socket(AF_INET,SOCK_DGRAM,0);
-    if( sfd == -1 ) {
-        CSmallString error;
-        error << "unable to create socket (" << strerror(errno) << ")";
-        ES_WARNING(error);
-        return(false);
-    }
-
-    int result = connect(sfd,(sockaddr*)&server_addr,sizeof(server_addr));
-
-    if( result == -1 ) {
-        CSmallString error;
-        error << "unable to connect to server " << name
-              << "[" << ip << "] (" << strerror(errno) << ")";
-        ES_WARNING(error);
-        return(false);
-    }
-
-    // send module datagram to server
-
-    if (send(sfd, &Datagram, sizeof(Datagram), MSG_NOSIGNAL) != sizeof(Datagram)) {
-        ES_WARNING("unable to send datagram");
-        exit(EXIT_FAILURE);
-    }
-
-    // close stream
-    close(sfd);
-
+    // the datagram is sent when the command is finished
+    StatDatagramQueue.AddDatagram(servername,port,format,Datagram);
     return(true);
 }
 
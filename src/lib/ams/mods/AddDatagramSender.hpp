@@ -31,7 +31,7 @@
 class CAddDatagramSender : public CStatDatagramSender {
 public:
     /// send datagram
-    virtual bool SendDataToServer(const CSmallString& servername,int port);
+    virtual bool SendDataToServer(const CSmallString& servername,int port,int format);
 
     /// get datagram flags
     virtual int GetFlags(void);
@@ -0,0 +1,555 @@
+// =============================================================================
+// AMS
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//    Copyright (C) 2012      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+
+#include <DirTree.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <system_error>
+#include <atomic>
+#include <deque>
+#include <string.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+using namespace boost;
+using namespace boost::algorithm;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+// parallel scanner of directory trees
+// each worker owns a queue of directories to scan, it takes the most recently
+// added directory from its own queue and steals the oldest one from queues of
+// other workers when idle, workers without any task to steal sleep until
+// a new task is queued or the scan is complete
+
+class CDirScanner {
+public:
+    struct STask {
+        std::string     Path;
+        unsigned int    ID;
+        int             Level;
+    };
+
+    struct SRecord {
+        unsigned int    ID;
+        unsigned int    ParentID;
+        std::string     Name;
+    };
+
+    struct SWorker {
+        std::mutex              Lock;
+        std::deque<STask>       Tasks;
+        std::vector<SRecord>    Records;
+    };
+
+    CDirScanner(int nthreads);
+
+    /// scan directory tree, the root has ID 0
+    void Scan(const std::string& path,const std::string& filter,int level);
+
+    /// get all found directories sorted by IDs, parents precede their children
+    void GetRecords(std::vector<SRecord>& records);
+
+private:
+    std::vector<SWorker>        Workers;
+    std::atomic<unsigned int>   NextID;
+    std::atomic<int>            Pending;        // number of queued or running tasks
+    std::atomic<int>            Queued;         // number of queued tasks
+    std::mutex                  IdleLock;
+    std::condition_variable     Idle;           // signaled by PushTask and at the end
+    std::string                 Filter;         // only for the root directory
+
+    void ExecuteWorker(int wid);
+    bool PopTask(int wid,STask& task);
+    bool StealTask(int wid,STask& task);
+    void PushTask(int wid,const STask& task);
+    void WaitForTask(void);
+    void ScanDirectory(int wid,const STask& task);
+};
+
+//------------------------------------------------------------------------------
+
+CDirScanner::CDirScanner(int nthreads)
+    : Workers(nthreads > 0 ? nthreads : 1)
+{
+    NextID = 1;
+    Pending = 0;
+    Queued = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void CDirScanner::Scan(const std::string& path,const std::string& filter,int level)
+{
+    Filter = filter;
+
+    STask root;
+    root.Path = path;
+    root.ID = 0;
+    root.Level = level;
+    PushTask(0,root);
+
+    // the calling thread is also a worker, it scans the whole tree
+    // if no thread can be started
+    std::vector<std::thread> threads;
+    for(size_t i=1; i < Workers.size(); i++){
+        try {
+            threads.push_back(std::thread(&CDirScanner::ExecuteWorker,this,(int)i));
+        } catch(std::system_error&) {
+            break;
+        }
+    }
+    ExecuteWorker(0);
+    for(std::thread& thread : threads){
+        thread.join();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CDirScanner::GetRecords(std::vector<SRecord>& records)
+{
+    for(SWorker& worker : Workers){
+        records.insert(records.end(),worker.Records.begin(),worker.Records.end());
+        worker.Records.clear();
+    }
+    // child IDs are always allocated after the parent ID
+    std::sort(records.begin(),records.end(),
+              [](const SRecord& left,const SRecord& right){ return(left.ID < right.ID); });
+}
+
+//------------------------------------------------------------------------------
+
+void CDirScanner::ExecuteWorker(int wid)
+{
+    for(;;){
+        STask task;
+        if( PopTask(wid,task) || StealTask(wid,task) ){
+            ScanDirectory(wid,task);
+            if( --Pending == 0 ){
+                std::lock_guard<std::mutex> guard(IdleLock);
+                Idle.notify_all();
+            }
+            continue;
+        }
+        if( Pending == 0 ) break;
+        WaitForTask();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CDirScanner::WaitForTask(void)
+{
+    // the condition is tested under IdleLock, the notification cannot be lost
+    std::unique_lock<std::mutex> lock(IdleLock);
+    Idle.wait(lock,[this](){ return( (Pending == 0) || (Queued > 0) ); });
+}
+
+//------------------------------------------------------------------------------
+
+bool CDirScanner::PopTask(int wid,STask& task)
+{
+    SWorker& worker = Workers[wid];
+    std::lock_guard<std::mutex> guard(worker.Lock);
+    if( worker.Tasks.empty() ) return(false);
+    task = worker.Tasks.back();
+    worker.Tasks.pop_back();
+    Queued--;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CDirScanner::StealTask(int wid,STask& task)
+{
+    for(size_t i=1; i < Workers.size(); i++){
+        SWorker& victim = Workers[(wid + i) % Workers.size()];
+        std::lock_guard<std::mutex> guard(victim.Lock);
+        if( victim.Tasks.empty() ) continue;
+        task = victim.Tasks.front();
+        victim.Tasks.pop_front();
+        Queued--;
+        return(true);
+    }
+    return(false);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirScanner::PushTask(int wid,const STask& task)
+{
+    Pending++;
+    {
+        SWorker& worker = Workers[wid];
+        std::lock_guard<std::mutex> guard(worker.Lock);
+        worker.Tasks.push_back(task);
+        Queued++;
+    }
+    std::lock_guard<std::mutex> guard(IdleLock);
+    Idle.notify_one();
+}
+
+//------------------------------------------------------------------------------
+
+void CDirScanner::ScanDirectory(int wid,const STask& task)
+{
+    DIR* p_dir = opendir(task.Path.c_str());
+    if( p_dir == NULL ) return;
+
+    struct dirent* p_ent;
+    while( (p_ent = readdir(p_dir)) != NULL ){
+        if( strcmp(p_ent->d_name,".") == 0 ) continue;
+        if( strcmp(p_ent->d_name,"..") == 0 ) continue;
+        if( strcmp(p_ent->d_name,"_ams_bundle") == 0 ) continue;
+        if( (task.ID == 0) && (! Filter.empty()) && (Filter != p_ent->d_name) ) continue;
+
+        std::string child_path = task.Path + "/" + p_ent->d_name;
+
+        // d_type avoids stat for regular entries, symlinks are followed
+        bool is_dir = false;
+        switch(p_ent->d_type){
+            case DT_DIR:
+                is_dir = true;
+                break;
+            case DT_LNK:
+            case DT_UNKNOWN:{
+                struct stat info;
+                is_dir = (stat(child_path.c_str(),&info) == 0) && S_ISDIR(info.st_mode);
+                }
+                break;
+            default:
+                break;
+        }
+        if( is_dir == false ) continue;
+
+        SRecord record;
+        record.ID = NextID++;
+        record.ParentID = task.ID;
+        record.Name = p_ent->d_name;
+        Workers[wid].Records.push_back(record);
+
+        if( task.Level != 0 ){
+            STask child;
+            child.Path = child_path;
+            child.ID = record.ID;
+            child.Level = task.Level - 1;
+            PushTask(wid,child);
+        }
+    }
+
+    closedir(p_dir);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CDirTree::CDirTree(void)
+{
+    // empty string has offset 0
+    Pool.push_back('\0');
+
+    SDirNode root;
+    root.Name = 0;
+    root.Build = 0;
+    root.Exists = false;
+    root.Orphaned = false;
+    Nodes.push_back(root);
+
+    // the scan is latency bound on network filesystems
+    NumOfThreads = std::thread::hardware_concurrency();
+    if( NumOfThreads < 4 ) NumOfThreads = 4;
+    if( NumOfThreads > 16 ) NumOfThreads = 16;
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::SetNumOfThreads(int nthreads)
+{
+    NumOfThreads = nthreads;
+    if( NumOfThreads < 1 ) NumOfThreads = 1;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+unsigned int CDirTree::AddString(const std::string& str)
+{
+    if( str.empty() ) return(0);
+    unsigned int offset = Pool.size();
+    Pool.insert(Pool.end(),str.begin(),str.end());
+    Pool.push_back('\0');
+    return(offset);
+}
+
+//------------------------------------------------------------------------------
+
+const char* CDirTree::GetString(unsigned int offset) const
+{
+    return(&Pool[offset]);
+}
+
+//------------------------------------------------------------------------------
+
+unsigned int CDirTree::GetChild(unsigned int parent,const std::string& name)
+{
+    std::vector<unsigned int>& children = Nodes[parent].Children;
+
+    std::vector<unsigned int>::iterator it = std::lower_bound(children.begin(),children.end(),name,
+        [this](unsigned int node,const std::string& name){ return( name.compare(GetString(Nodes[node].Name)) > 0 ); });
+
+    if( (it != children.end()) && (name == GetString(Nodes[*it].Name)) ){
+        return(*it);
+    }
+
+    SDirNode node;
+    node.Name = AddString(name);
+    node.Build = 0;
+    node.Exists = false;
+    node.Orphaned = false;
+
+    unsigned int index = Nodes.size();
+    // insert before Nodes are reallocated by push_back
+    children.insert(it,index);
+    Nodes.push_back(node);
+
+    return(index);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CDirTree::AddPackageDir(const CFileName& path,const CSmallString& build)
+{
+    string sdirs = string(path);
+
+    vector<string> dir_list;
+    split(dir_list,sdirs,is_any_of("/"));
+
+    unsigned int node = 0;
+    for(const string& dir : dir_list){
+        node = GetChild(node,dir);
+    }
+
+    if( node != 0 ){
+        Nodes[node].Build = AddString(string(build));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::ScanSoftRepoTree(const CFileName& path,int level)
+{
+    ScanTree(path,"",level);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::ScanSoftRepoTree(const CFileName& path,const CFileName& subdir,int level)
+{
+    ScanTree(path,string(subdir),level);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::ScanTree(const CFileName& path,const std::string& filter,int level)
+{
+    CDirScanner scanner(NumOfThreads);
+    scanner.Scan(string(path),filter,level);
+
+    std::vector<CDirScanner::SRecord> records;
+    scanner.GetRecords(records);
+
+    // map scanner IDs to tree nodes, parents are always processed before their children
+    std::vector<unsigned int> nodes(records.size()+1);
+    nodes[0] = 0;
+
+    for(const CDirScanner::SRecord& record : records){
+        unsigned int node = GetChild(nodes[record.ParentID],record.Name);
+        Nodes[node].Exists = true;
+        nodes[record.ID] = node;
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CDirTree::PrintTree(std::ostream& vout)
+{
+    PrintTree(vout,0,0);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::PrintTree(std::ostream& vout,unsigned int node,int level)
+{
+    const SDirNode& item = Nodes[node];
+
+    if( level > 0 ){
+        for(int i=1; i < level; i++){
+            vout << "    ";
+        }
+        if( level > 1 ){
+            vout << "|-";
+        }
+        if( item.Exists == false ){
+            vout << "<red>" << GetString(item.Name) << "</red>";
+        } else {
+            vout << GetString(item.Name);
+        }
+        if( item.Children.size() == 0 ){
+            vout << " " << GetString(item.Build);
+        }
+        vout << endl;
+    }
+
+    for(unsigned int child : item.Children){
+        PrintTree(vout,child,level+1);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::PrintMissing(std::ostream& vout,const CFileName& path)
+{
+    PrintMissing(vout,0,path);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::PrintMissing(std::ostream& vout,unsigned int node,const CFileName& path)
+{
+    const SDirNode& item = Nodes[node];
+
+    CFileName new_path = path;
+    if( item.Name != 0 ){
+        new_path = new_path / GetString(item.Name);
+    }
+
+    for(unsigned int child : item.Children){
+        PrintMissing(vout,child,new_path);
+    }
+
+    if( (item.Children.size() == 0) && (item.Exists == false) && (item.Build != 0) ){
+        vout << left << setw(40) << GetString(item.Build) << "" << new_path << endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::PrintExisting(std::ostream& vout,const CFileName& path)
+{
+    PrintExisting(vout,0,path);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::PrintExisting(std::ostream& vout,unsigned int node,const CFileName& path)
+{
+    const SDirNode& item = Nodes[node];
+
+    CFileName new_path = path;
+    if( item.Name != 0 ){
+        new_path = new_path / GetString(item.Name);
+    }
+
+    for(unsigned int child : item.Children){
+        PrintExisting(vout,child,new_path);
+    }
+
+    if( (item.Children.size() == 0) && (item.Exists == true) && (item.Build != 0) ){
+        vout << left << setw(40) << GetString(item.Build) << "" << new_path << endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::PrintOrphans(std::ostream& vout,const CFileName& path)
+{
+    PrintOrphans(vout,0,path);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::PrintOrphans(std::ostream& vout,unsigned int node,const CFileName& path)
+{
+    const SDirNode& item = Nodes[node];
+
+    CFileName new_path = path;
+    if( item.Name != 0 ){
+        new_path = new_path / GetString(item.Name);
+    }
+
+    for(unsigned int child : item.Children){
+        PrintOrphans(vout,child,new_path);
+    }
+
+    if( item.Orphaned ){
+        vout << new_path << endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::CountOrphanedChilds(void)
+{
+    CountOrphanedChilds(0);
+}
+
+//------------------------------------------------------------------------------
+
+void CDirTree::CountOrphanedChilds(unsigned int node)
+{
+    unsigned int count = 0;
+    for(unsigned int child : Nodes[node].Children){
+        CountOrphanedChilds(child);
+        if( Nodes[child].Orphaned == true ) count++;
+    }
+
+    SDirNode& item = Nodes[node];
+    if( (count == item.Children.size()) && (item.Children.size() > 0) ){
+        item.Orphaned = true;
+    }
+    if( item.Children.size() == 0 ){
+        if( (item.Build == 0) && (item.Exists == true) ){
+            item.Orphaned = true;
+        }
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -1,5 +1,5 @@
-#ifndef DirNodeItemH
-#define DirNodeItemH
+#ifndef DirTreeH
+#define DirTreeH
 // =============================================================================
 // AMS
 // -----------------------------------------------------------------------------
@@ -21,25 +21,26 @@
 //     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 // =============================================================================
 
-#include <map>
+#include <AMSMainHeader.hpp>
+#include <vector>
 #include <string>
-#include <boost/shared_ptr.hpp>
+#include <ostream>
 #include <SmallString.hpp>
 #include <FileName.hpp>
 
 // -----------------------------------------------------------------------------
 
-class CDirNodeItem;
-typedef boost::shared_ptr<CDirNodeItem>    CDirNodeItemPtr;
-
-// -----------------------------------------------------------------------------
-
-class CDirNodeItem {
+/// software repository tree - nodes are stored in a single array and
+/// their names and builds in a common string pool
+class AMS_PACKAGE CDirTree {
 public:
 // constructor -----------------------------------------------------------------
-        CDirNodeItem(void);
+        CDirTree(void);
 
 // main methods ----------------------------------------------------------------
+    /// set number of threads used to scan the filesystem
+    void SetNumOfThreads(int nthreads);
+
     /// add build path
     void AddPackageDir(const CFileName& path,const CSmallString& build);
 
@@ -50,7 +51,7 @@ public:
     void ScanSoftRepoTree(const CFileName& path,const CFileName& subdir,int level);
 
     /// print tree with various flags
-    void PrintTree(std::ostream& vout,const CFileName& path,int level);
+    void PrintTree(std::ostream& vout);
 
     /// print missing records
     void PrintMissing(std::ostream& vout,const CFileName& path);
@@ -64,13 +65,38 @@ public:
     /// print orphaned directories
     void PrintOrphans(std::ostream& vout,const CFileName& path);
 
-// section of public data ------------------------------------------------------
-public:
-    CFileName                               Name;
-    std::map<std::string,CDirNodeItemPtr>   SubItems;
-    CSmallString                            Build;          // associated build
-    bool                                    Exists;         // exists on FS
-    bool                                    Orphaned;       // node is orphaned
+// section of private data -----------------------------------------------------
+private:
+    struct SDirNode {
+        unsigned int                Name;           // offset of name in the string pool
+        unsigned int                Build;          // offset of associated build in the string pool
+        bool                        Exists;         // exists on FS
+        bool                        Orphaned;       // node is orphaned
+        std::vector<unsigned int>   Children;       // sorted by names
+    };
+
+    std::vector<SDirNode>   Nodes;                  // the first node is the root
+    std::vector<char>       Pool;                   // names and builds terminated by '\0'
+    int                     NumOfThreads;
+
+    /// add string to the pool
+    unsigned int AddString(const std::string& str);
+
+    /// get string from the pool
+    const char* GetString(unsigned int offset) const;
+
+    /// find or create child node
+    unsigned int GetChild(unsigned int parent,const std::string& name);
+
+    /// scan the filesystem and merge found directories into the tree
+    void ScanTree(const CFileName& path,const std::string& filter,int level);
+
+    // helper methods
+    void PrintTree(std::ostream& vout,unsigned int node,int level);
+    void PrintMissing(std::ostream& vout,unsigned int node,const CFileName& path);
+    void PrintExisting(std::ostream& vout,unsigned int node,const CFileName& path);
+    void CountOrphanedChilds(unsigned int node);
+    void PrintOrphans(std::ostream& vout,unsigned int node,const CFileName& path);
 };
 
 // -----------------------------------------------------------------------------
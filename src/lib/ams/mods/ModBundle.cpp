@@ -38,6 +38,13 @@
 #include <PrintEngine.hpp>
 #include <FSIndex.hpp>
 #include <UserUtils.hpp>
+#include <AMSProfiler.hpp>
+#include <ShellProcessor.hpp>
+#include <sstream>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
 
 //------------------------------------------------------------------------------
 
@@ -49,6 +56,7 @@ using namespace boost::algorithm;
 
 #define _AMS_BUNDLE "_ams_bundle"
 #define _AMS_BLDS   "blds"
+#define _AMS_DOCS   "cache_docs"
 
 //==============================================================================
 //------------------------------------------------------------------------------
@@ -57,6 +65,7 @@ using namespace boost::algorithm;
 CModBundle::CModBundle(void)
 {
     CacheType               = EMBC_NONE;
+    CacheDeferred           = false;
     PersonalBundle          = false;
 
     NumOfAllBuilds          = 0;
@@ -94,6 +103,53 @@ bool CModBundle::IsBundle(const CFileName& path,const CFileName& name)
 
 //------------------------------------------------------------------------------
 
+const CSmallString CModBundle::GetCacheSignature(const CFileName& path,const CFileName& name)
+{
+    std::stringstream signature;
+    signature << (const char*)(path / name);
+
+    const char* files[] = {"config.xml","cache.xml"};
+    for(const char* p_file : files){
+        CFileName   file_name = path / name / _AMS_BUNDLE / p_file;
+        struct stat info;
+        if( stat(file_name,&info) == 0 ){
+            signature << ":" << info.st_ino << ":" << info.st_size
+                      << ":" << info.st_mtim.tv_sec << "." << info.st_mtim.tv_nsec;
+        } else {
+            signature << ":-";
+        }
+    }
+
+    return(signature.str().c_str());
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundle::PrefetchBundle(const CFileName& path,const CFileName& name,EModBundleCache type)
+{
+    CFileName   config_dir = path / name / _AMS_BUNDLE;
+    struct stat info;
+    if( (stat(config_dir,&info) != 0) || (S_ISDIR(info.st_mode) == 0) ) return(false);
+
+    const char* files[] = {"config.xml","audit.xml",NULL};
+    if( type == EMBC_BIG ) files[2] = "cache_big.xml";
+    if( type == EMBC_SMALL ) files[2] = "cache.xml";
+
+    for(const char* p_file : files){
+        if( p_file == NULL ) continue;
+        int fd = open(config_dir / p_file,O_RDONLY);
+        if( fd < 0 ) continue;
+        // read the whole file, readahead hints are not reliable on network filesystems
+        char buffer[65536];
+        while( read(fd,buffer,sizeof(buffer)) > 0 );
+        close(fd);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
 bool CModBundle::CreateBundle(const CFileName& path,const CFileName& name,
                               const CSmallString& maintainer,const CSmallString& contact,bool force)
 {
@@ -237,12 +293,19 @@ void CModBundle::FindAllFragmentFiles(void)
 {
     CFileName blds = BundlePath / BundleName / _AMS_BUNDLE / _AMS_BLDS;
 
+    // single pass over the tree
+    std::vector<CFileName>              patterns;
+    std::vector< std::list<CFileName> > files;
+    patterns.push_back("*.bld");
+    patterns.push_back("*.doc");
+    CUtils::FindAllFiles(blds,patterns,files);
+
     BldFiles.clear();
-    CUtils::FindAllFiles(blds,"*.bld",BldFiles);
+    BldFiles.swap(files[0]);
     BldFiles.sort();
 
     DocFiles.clear();
-    CUtils::FindAllFiles(blds,"*.doc",DocFiles);
+    DocFiles.swap(files[1]);
     DocFiles.sort();
 }
 
@@ -315,6 +378,8 @@ void CModBundle::PrintInfo(CVerboseStr& vout,bool mods,bool stat,bool audit)
     vout << "# Maintainer  : " << GetMaintainerName() << " (" << GetMaintainerEMail() << ")" << endl;
 
     if( mods ){
+    // module statistics need the cache
+    if( CacheDeferred ) LoadCache(CacheType);
     switch(CacheType) {
     case(EMBC_SMALL):
     vout << "# Cache type  : small" << endl;
@@ -394,6 +459,8 @@ const CFileName CModBundle::GetBundleRootPath(void)
 
 bool CModBundle::RebuildCache(CVerboseStr& vout)
 {
+    CAMSProfilerPhase phase("bundle-cache-rebuild");
+
     CFileName blds = BundlePath / BundleName / _AMS_BUNDLE / _AMS_BLDS;
 
 // empty cache
@@ -477,11 +544,12 @@ bool CModBundle::RebuildCache(CVerboseStr& vout)
 //------------------------------------------------------------------------------
 //==============================================================================
 
-bool CModBundle::LoadCache(EModBundleCache type)
+bool CModBundle::LoadCache(EModBundleCache type,bool readonly)
 {
     CFileName config_dir = BundlePath / BundleName / _AMS_BUNDLE;
 
     CacheType = EMBC_NONE;
+    CacheDeferred = false;
 
 // load the cache
     if( type == EMBC_BIG ){
@@ -490,6 +558,12 @@ bool CModBundle::LoadCache(EModBundleCache type)
             return(false);
         }
         CacheType = EMBC_BIG;
+    } else if( (type == EMBC_SMALL) && readonly ) {
+        if( LoadReadOnlyCacheFile(config_dir / "cache.xml") == false ){
+            ES_WARNING("unable to load small cache");
+            return(false);
+        }
+        CacheType = EMBC_SMALL;
     } else if( type == EMBC_SMALL ) {
         if( LoadCacheFile(config_dir / "cache.xml") == false ){
             ES_WARNING("unable to load small cache");
@@ -503,8 +577,46 @@ bool CModBundle::LoadCache(EModBundleCache type)
 
 //------------------------------------------------------------------------------
 
+bool CModBundle::DeferCache(EModBundleCache type)
+{
+    CacheType = type;
+    CacheDeferred = false;
+
+    CFileName cache_file = GetCacheFileName();
+    if( CFileSystem::IsFile(cache_file) == false ){
+        CacheType = EMBC_NONE;
+        CSmallString error;
+        error << "no module cache file yet: '" << cache_file << "'";
+        ES_WARNING(error);
+        return(false);
+    }
+
+    CacheDeferred = true;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundle::IsCacheDeferred(void) const
+{
+    return(CacheDeferred);
+}
+
+//------------------------------------------------------------------------------
+
+const CFileName CModBundle::GetCacheFileName(void)
+{
+    CFileName config_dir = BundlePath / BundleName / _AMS_BUNDLE;
+    if( CacheType == EMBC_BIG ) return(config_dir / "cache_big.xml");
+    return(config_dir / "cache.xml");
+}
+
+//------------------------------------------------------------------------------
+
 bool CModBundle::SaveCaches(void)
 {
+    CAMSProfilerPhase phase("bundle-cache-save");
+
     CFileName config_dir = BundlePath / BundleName / _AMS_BUNDLE;
 
 // save the whole cache
@@ -513,6 +625,12 @@ bool CModBundle::SaveCaches(void)
         return(false);
     }
 
+// help needs only documentation of requested modules
+    if( SaveDocumentationCache() == false ){
+        ES_ERROR("unable to save documentation cache");
+        return(false);
+    }
+
 // clean unnecessary parts
     RemoveDocumentation();
     CXMLElement* p_cele = Cache.GetFirstChildElement("cache");
@@ -526,6 +644,134 @@ bool CModBundle::SaveCaches(void)
     return(true);
 }
 
+//------------------------------------------------------------------------------
+
+bool CModBundle::SaveDocumentationCache(void)
+{
+    CFileName docs_dir = BundlePath / BundleName / _AMS_BUNDLE / _AMS_DOCS;
+
+    if( CFileSystem::IsDirectory(docs_dir) == false ){
+        if( CFileSystem::CreateDir(docs_dir) == false ){
+            CSmallString error;
+            error << "unable to create documentation cache directory '" << docs_dir << "'";
+            ES_ERROR(error);
+            return(false);
+        }
+    }
+
+    CXMLElement* p_cele = Cache.GetFirstChildElement("cache");
+    if( p_cele == NULL ){
+        ES_ERROR("unable to open cache element");
+        return(false);
+    }
+
+    std::set<CFileName> doc_files;
+
+    CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
+    while( p_mele != NULL ) {
+        CSmallString    name;
+        CXMLElement*    p_dele = GetModuleDoc(p_mele);
+        p_mele->GetAttribute("name",name);
+        p_mele = p_mele->GetNextSiblingElement("module");
+        if( (p_dele == NULL) || (name == NULL) ) continue;
+
+        CXMLDocument doc;
+        doc.CreateChildDeclaration();
+        CXMLElement* p_root = doc.CreateChildElement("doc");
+        p_root->CopyChildNodesFrom(p_dele);
+
+        CFileName doc_file = docs_dir / CFileName(name + ".xml");
+
+        CXMLPrinter xml_printer;
+        xml_printer.SetPrintedXMLNode(&doc);
+        xml_printer.SetPrintAsItIs(true);
+
+        if( xml_printer.Print(doc_file) == false ){
+            CSmallString error;
+            error << "unable to save module documentation '" << doc_file << "'";
+            ES_ERROR(error);
+            return(false);
+        }
+        doc_files.insert(doc_file);
+    }
+
+    // remove documentation of removed modules
+    std::list<CFileName> files;
+    CUtils::FindAllFiles(docs_dir,"*.xml",files);
+    for(CFileName file : files){
+        if( doc_files.count(file) == 0 ) CFileSystem::RemoveFile(file);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundle::LoadModuleDoc(CXMLElement* p_mele,CXMLDocument& doc)
+{
+    doc.RemoveAllChildNodes();
+    if( p_mele == NULL ) return(false);
+
+    CSmallString name;
+    p_mele->GetAttribute("name",name);
+
+    CXMLElement* p_bele = p_mele->GetFirstChildElement("bundle");
+    if( p_bele == NULL ) return(false);
+
+    CFileName bpath,bname;
+    p_bele->GetAttribute("path",bpath);
+    p_bele->GetAttribute("name",bname);
+
+    CFileName config_dir = bpath / bname / _AMS_BUNDLE;
+    CFileName docs_dir = config_dir / _AMS_DOCS;
+    CFileName doc_file = docs_dir / CFileName(name + ".xml");
+
+    CXMLParser xml_parser;
+    xml_parser.SetOutputXMLNode(&doc);
+    xml_parser.EnableWhiteCharacters(true);
+
+    if( CFileSystem::IsFile(doc_file) ){
+        if( xml_parser.Parse(doc_file) == false ){
+            CSmallString error;
+            error << "unable to parse module documentation '" << doc_file << "'";
+            ES_ERROR(error);
+            return(false);
+        }
+        return(doc.GetFirstChildElement("doc") != NULL);
+    }
+
+    // no documentation file is saved for undocumented modules
+    if( CFileSystem::IsDirectory(docs_dir) ) return(false);
+
+    // caches saved by older versions do not have per-module documentation
+    CFileName big_cache = config_dir / "cache_big.xml";
+    if( CFileSystem::IsFile(big_cache) == false ) return(false);
+
+    CXMLDocument cache;
+    xml_parser.SetOutputXMLNode(&cache);
+    if( xml_parser.Parse(big_cache) == false ){
+        CSmallString error;
+        error << "unable to parse big cache '" << big_cache << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    CXMLElement* p_cmele = cache.GetChildElementByPath("cache/module");
+    while( p_cmele != NULL ){
+        CSmallString lname;
+        p_cmele->GetAttribute("name",lname);
+        if( lname == name ) break;
+        p_cmele = p_cmele->GetNextSiblingElement("module");
+    }
+
+    CXMLElement* p_dele = GetModuleDoc(p_cmele);
+    if( p_dele == NULL ) return(false);
+
+    CXMLElement* p_root = doc.CreateChildElement("doc");
+    p_root->CopyChildNodesFrom(p_dele);
+    return(true);
+}
+
 //==============================================================================
 //------------------------------------------------------------------------------
 //==============================================================================
@@ -680,6 +926,9 @@ bool CModBundle::AddBuild(CVerboseStr& vout,CXMLElement* p_cele, const CFileName
     p_bele->RemoveAttribute("name");
     CleanBuild(p_bele);
 
+// precompile setup into programs executed by the shell processor
+    CShellProcessor::CompileSetupProgram(p_bele);
+
 // include module build to cache
     if( p_bele->DuplicateNode(p_builds) == NULL ) {
         CSmallString error;
@@ -716,7 +965,9 @@ void CModBundle::RebuildModuleDefaultBuilds(void)
 
     CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
     while( p_mele != NULL ){
+        CModCache::SortModuleBuilds(p_mele);
         InitDefaultBuild(p_mele);
+        CModCache::UpdateModuleAvail(p_mele);
         p_mele = p_mele->GetNextSiblingElement("module");
     }
 }
@@ -738,7 +989,15 @@ void CModBundle::InitDefaultBuild(CXMLElement* p_mele)
     bool         first = true;
     double       defverindx;
 
-    CXMLElement* p_bele = p_mele->GetChildElementByPath("builds/build");
+    // version index is sorted - the first version is the default one
+    CXMLElement* p_vele = p_mele->GetChildElementByPath("versions/version");
+    if( p_vele != NULL ){
+        p_vele->GetAttribute("ver",defver);
+        if( defver != NULL ) first = false;
+    }
+
+    CXMLElement* p_bele = NULL;
+    if( first ) p_bele = p_mele->GetChildElementByPath("builds/build");
     while( p_bele != NULL ){
         CSmallString    ver;
         double          verindx;
@@ -936,12 +1195,50 @@ void CModBundle::CalculateNewIndex(CVerboseStr& vout)
 
 //------------------------------------------------------------------------------
 
+void CModBundle::CalculateDedupReport(CVerboseStr& vout,bool verbose)
+{
+    if( verbose ){
+        vout << endl;
+        vout << "# Scanning builds ..." << endl;
+    }
+
+    CFSIndex index;
+    if( PersonalBundle ){
+        index.RootDir = BundlePath / BundleName;
+    } else {
+        index.RootDir = BundlePath;
+    }
+    index.PersonalBundle = PersonalBundle;
+    index.CollectFiles = true;
+
+    map<CSmallString,CFileName>::iterator it = NewBundleIndex.Paths.begin();
+    map<CSmallString,CFileName>::iterator ie = NewBundleIndex.Paths.end();
+
+    while( it != ie ){
+        index.CalculateBuildHash(it->second);
+        it++;
+    }
+
+    index.FindDuplicates();
+
+    if( verbose ){
+        index.PrintDedupReport(vout);
+        vout << endl;
+        vout << "# Hardlink plan (L sha1 size source target) ..." << endl;
+    }
+
+    vout << low;
+    index.PrintHardlinkPlan(vout);
+}
+
+//------------------------------------------------------------------------------
+
 bool CModBundle::SaveNewIndex(void)
 {
     CFileName index_name;
     index_name = BundlePath / BundleName / _AMS_BUNDLE / "index.new";
 
-    return(NewBundleIndex.SaveIndex(index_name));
+    return(NewBundleIndex.SaveSnapshot(index_name));
 }
 
 //------------------------------------------------------------------------------
@@ -954,11 +1251,24 @@ bool CModBundle::CommitNewIndex(void)
     CFileName old_index_name;
     old_index_name = BundlePath / BundleName / _AMS_BUNDLE / "index.old";
 
-    if( CFileSystem::CopyFile(new_index_name,old_index_name,true) == false ){
+    // index.old is a snapshot mapped by concurrent readers - never rewrite it in place
+    CFileName tmp_index_name;
+    tmp_index_name = BundlePath / BundleName / _AMS_BUNDLE / "index.old.tmp";
+
+    if( CFileSystem::CopyFile(new_index_name,tmp_index_name,true) == false ){
         CSmallString error;
         error << "unable to copy the new index '" << new_index_name;
+        error << "' to '" << tmp_index_name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    if( rename(tmp_index_name,old_index_name) != 0 ){
+        CSmallString error;
+        error << "unable to rename '" << tmp_index_name;
         error << "' over old index '" << old_index_name << "'";
         ES_ERROR(error);
+        unlink(tmp_index_name);
         return(false);
     }
 
@@ -976,13 +1286,13 @@ bool CModBundle::LoadIndexes(void)
 
     bool result = true;
     if( CFileSystem::IsFile(new_index_name) ){
-        result &= NewBundleIndex.LoadIndex(new_index_name);
+        result &= NewIndexSnapshot.OpenIndex(new_index_name);
     }
 
     CFileName old_index_name;
     old_index_name = BundlePath / BundleName / _AMS_BUNDLE / "index.old";
     if( CFileSystem::IsFile(old_index_name) ){
-        result &= OldBundleIndex.LoadIndex(old_index_name);
+        result &= OldIndexSnapshot.OpenIndex(old_index_name);
     }
 
     return(result);
@@ -993,7 +1303,20 @@ bool CModBundle::LoadIndexes(void)
 void CModBundle::DiffIndexes(CVerboseStr& vout, bool skip_removed,
                              bool skip_added, bool verbose)
 {
-    NewBundleIndex.Diff(OldBundleIndex,vout,skip_removed,skip_added,verbose);
+    NewIndexSnapshot.Diff(OldIndexSnapshot,vout,skip_removed,skip_added,verbose);
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundle::ExportNewIndex(const CFileName& index_name)
+{
+    CFileName new_index_name;
+    new_index_name = BundlePath / BundleName / _AMS_BUNDLE / "index.new";
+
+    CModBundleIndex index;
+    if( index.LoadIndex(new_index_name) == false ) return(false);
+
+    return(index.SaveIndex(index_name));
 }
 
 //==============================================================================
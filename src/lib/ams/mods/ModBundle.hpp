@@ -31,6 +31,7 @@
 #include <VerboseStr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <ModBundleIndex.hpp>
+#include <ModBundleIndexSnapshot.hpp>
 #include <set>
 #include <map>
 
@@ -56,6 +57,13 @@ public:
     /// is bundle?
     static bool IsBundle(const CFileName& path,const CFileName& name);
 
+    /// get signature of bundle config and small cache (inode, size, and mtime)
+    static const CSmallString GetCacheSignature(const CFileName& path,const CFileName& name);
+
+    /// read bundle files needed by InitBundle and LoadCache into the page cache,
+    /// it does not use the error system and thus can be called from worker threads
+    static bool PrefetchBundle(const CFileName& path,const CFileName& name,EModBundleCache type);
+
     /// initialize bundle
     bool CreateBundle(const CFileName& path,const CFileName& name,
                       const CSmallString& maintainer,const CSmallString& contact,bool froce);
@@ -70,12 +78,26 @@ public:
     /// rebuild bundle caches
     bool RebuildCache(CVerboseStr& vout);
 
-    /// load cache
-    bool LoadCache(EModBundleCache type);
+    /// load cache, the small cache can be loaded in the read-only mode
+    bool LoadCache(EModBundleCache type,bool readonly=false);
+
+    /// defer loading of the cache, the cache file is then streamed into
+    /// the merged cache by MergeWithCacheFile or loaded on the first PrintInfo
+    bool DeferCache(EModBundleCache type);
+
+    /// is the cache deferred?
+    bool IsCacheDeferred(void) const;
+
+    /// get name of the cache file for the current cache type
+    const CFileName GetCacheFileName(void);
 
-    /// save small and big caches
+    /// save small and big caches, and per-module documentation
     bool SaveCaches(void);
 
+    /// load documentation of merged module from its bundle
+    /// per-module documentation is used, the big cache is the fallback for older bundles
+    static bool LoadModuleDoc(CXMLElement* p_mele,CXMLDocument& doc);
+
 // information methods ---------------------------------------------------------
     /// get bundle name
     const CFileName GetName(void);
@@ -111,12 +133,18 @@ public:
     /// save index
     bool SaveNewIndex(void);
 
+    /// find builds with identical files, print report and hardlink plan
+    void CalculateDedupReport(CVerboseStr& vout,bool verbose);
+
     /// commit index
     bool CommitNewIndex(void);
 
     /// load new and old indexes
     bool LoadIndexes(void);
 
+    /// export the new index in the text format
+    bool ExportNewIndex(const CFileName& index_name);
+
     /// diff two indexes
     void DiffIndexes(CVerboseStr& vout, bool skip_removed, bool skip_added, bool verbose);
 
@@ -127,6 +155,7 @@ private:
     CXMLDocument    Config;
     CXMLDocument    AuditLog;
     EModBundleCache CacheType;
+    bool            CacheDeferred;
 
     std::list<CFileName>    DocFiles;
     std::list<CFileName>    BldFiles;
@@ -148,18 +177,22 @@ private:
     std::set<CSmallString>              UniqueBuilds;
     std::set<CFileName>                 UniqueBuildPaths;
     CModBundleIndex                     NewBundleIndex;
-    CModBundleIndex                     OldBundleIndex;
+    CModBundleIndexSnapshot             NewIndexSnapshot;
+    CModBundleIndexSnapshot             OldIndexSnapshot;
 
     /// record audit message
     void AuditAction(const CSmallString& message);
 
+    /// save documentation of individual modules
+    bool SaveDocumentationCache(void);
+
     /// add documentation
     bool AddDocumentation(CVerboseStr& vout,CXMLElement* p_cele, const CFileName& docu_file);
 
     /// add build
     bool AddBuild(CVerboseStr& vout,CXMLElement* p_cele, const CFileName& build_file);
 
-    /// rebuild default build for all modules
+    /// rebuild default build and avail data for all modules
     void RebuildModuleDefaultBuilds(void);
 
     /// init default build element
@@ -27,6 +27,7 @@
 #include <ErrorSystem.hpp>
 #include <iomanip>
 #include <FSIndex.hpp>
+#include <ModBundleIndexSnapshot.hpp>
 
 //------------------------------------------------------------------------------
 
@@ -42,6 +43,11 @@ bool CModBundleIndex::LoadIndex(const CFileName& index_name)
     if( index_name == "-" ){
         IndexFile = "stdin";
         result = LoadIndex(cin);
+    } else if( CModBundleIndexSnapshot::IsSnapshot(index_name) ){
+        IndexFile = index_name;
+        CModBundleIndexSnapshot snapshot;
+        result = snapshot.OpenIndex(IndexFile);
+        if( result ) snapshot.ExportIndex(*this);
     } else {
         IndexFile = index_name;
         ifstream ifs(IndexFile);
@@ -136,6 +142,18 @@ bool CModBundleIndex::SaveIndex(std::ostream& ofs)
 
 //------------------------------------------------------------------------------
 
+bool CModBundleIndex::SaveSnapshot(const CFileName& index_name)
+{
+    if( index_name == "-" ){
+        IndexFile = "stdout";
+    } else {
+        IndexFile = index_name;
+    }
+    return(CModBundleIndexSnapshot::SaveSnapshot(*this,index_name));
+}
+
+//------------------------------------------------------------------------------
+
 void CModBundleIndex::Diff(CModBundleIndex& old_index, CVerboseStr& vout,
                            bool skip_removed, bool skip_added, bool verbose)
 {
@@ -33,7 +33,7 @@
 
 class AMS_PACKAGE CModBundleIndex {
 public:
-    /// load index
+    /// load index - text or binary snapshot
     bool LoadIndex(const CFileName& index_name);
 
     /// load index
@@ -45,6 +45,9 @@ public:
     /// save index
     bool SaveIndex(std::ostream& ofs);
 
+    /// save index as a binary snapshot
+    bool SaveSnapshot(const CFileName& index_name);
+
     /// diff two indexes
     void Diff(CModBundleIndex& old_index, CVerboseStr& vout, bool skip_removed,
               bool skip_added, bool verbose);
@@ -0,0 +1,478 @@
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <ModBundleIndexSnapshot.hpp>
+#include <ModBundleIndex.hpp>
+#include <ErrorSystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <iterator>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+static const char       SnapshotMagic[8] = {'A','M','S','I','D','X','S','N'};
+static const uint32_t   SnapshotVersion  = 2;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CModBundleIndexSnapshot::CModBundleIndexSnapshot(void)
+{
+    MapAddr         = NULL;
+    MapSize         = 0;
+    Records         = NULL;
+    NumOfRecords    = 0;
+    Pool            = NULL;
+}
+
+//------------------------------------------------------------------------------
+
+CModBundleIndexSnapshot::~CModBundleIndexSnapshot(void)
+{
+    Close();
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CModBundleIndexSnapshot::OpenIndex(const CFileName& index_name)
+{
+    Close();
+
+    CModBundleIndex index;
+
+    if( index_name == "-" ){
+        IndexFile = "stdin";
+        Buffer.assign(istreambuf_iterator<char>(cin),istreambuf_iterator<char>());
+        if( (Buffer.size() >= sizeof(SnapshotMagic)) &&
+            (memcmp(Buffer.data(),SnapshotMagic,sizeof(SnapshotMagic)) == 0) ){
+            return(SetData(Buffer.data(),Buffer.size()));
+        }
+        // text index
+        index.IndexFile = IndexFile;
+        stringstream str(Buffer);
+        if( index.LoadIndex(str) == false ) return(false);
+        if( BuildSnapshot(index,Buffer) == false ) return(false);
+        return(SetData(Buffer.data(),Buffer.size()));
+    }
+
+    IndexFile = index_name;
+
+    int fd = open(IndexFile,O_RDONLY);
+    if( fd < 0 ){
+        CSmallString error;
+        error << "Unable to open the index file '" << IndexFile << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    struct stat st;
+    if( fstat(fd,&st) != 0 ){
+        close(fd);
+        CSmallString error;
+        error << "Unable to stat the index file '" << IndexFile << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    if( (size_t)st.st_size >= sizeof(SHeader) ){
+        void* p_addr = mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+        if( p_addr == MAP_FAILED ){
+            close(fd);
+            CSmallString error;
+            error << "Unable to map the index file '" << IndexFile << "'";
+            ES_ERROR(error);
+            return(false);
+        }
+        if( memcmp(p_addr,SnapshotMagic,sizeof(SnapshotMagic)) == 0 ){
+            close(fd);
+            MapAddr = p_addr;
+            MapSize = st.st_size;
+            return(SetData((const char*)MapAddr,MapSize));
+        }
+        munmap(p_addr,st.st_size);
+    }
+    close(fd);
+
+    // text index
+    index.IndexFile = IndexFile;
+    ifstream ifs(IndexFile);
+    if( index.LoadIndex(ifs) == false ) return(false);
+    if( BuildSnapshot(index,Buffer) == false ) return(false);
+    return(SetData(Buffer.data(),Buffer.size()));
+}
+
+//------------------------------------------------------------------------------
+
+void CModBundleIndexSnapshot::Close(void)
+{
+    if( MapAddr != NULL ){
+        munmap(MapAddr,MapSize);
+    }
+    MapAddr         = NULL;
+    MapSize         = 0;
+    Records         = NULL;
+    NumOfRecords    = 0;
+    Pool            = NULL;
+    Buffer.clear();
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundleIndexSnapshot::SetData(const char* p_data,size_t size)
+{
+    const SHeader* p_header = reinterpret_cast<const SHeader*>(p_data);
+    if( (size < sizeof(SHeader)) || (memcmp(p_header->Magic,SnapshotMagic,sizeof(SnapshotMagic)) != 0) ||
+        (p_header->Version != SnapshotVersion) ){
+        CSmallString error;
+        error << "Unsupported index snapshot '" << IndexFile << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    uint64_t total_size = sizeof(SHeader) + (uint64_t)p_header->NumOfRecords*sizeof(SRecord) + p_header->PoolSize;
+    if( total_size != size ){
+        CSmallString error;
+        error << "Corrupted index snapshot '" << IndexFile << "' (size mismatch)";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    const SRecord*  p_records = reinterpret_cast<const SRecord*>(p_data + sizeof(SHeader));
+    const char*     p_pool = p_data + sizeof(SHeader) + p_header->NumOfRecords*sizeof(SRecord);
+
+    // all strings must be within the pool and terminated by zero
+    for(uint32_t i=0; i < p_header->NumOfRecords; i++){
+        const SRecord& rec = p_records[i];
+        if( ((uint64_t)rec.BuildOffset + rec.BuildLength >= p_header->PoolSize) ||
+            ((uint64_t)rec.PathOffset + rec.PathLength >= p_header->PoolSize) ||
+            (p_pool[rec.BuildOffset + rec.BuildLength] != '\0') ||
+            (p_pool[rec.PathOffset + rec.PathLength] != '\0') ){
+            CSmallString error;
+            error << "Corrupted index snapshot '" << IndexFile << "' at record " << (int)i;
+            ES_ERROR(error);
+            return(false);
+        }
+    }
+
+    Records         = p_records;
+    NumOfRecords    = p_header->NumOfRecords;
+    Pool            = p_pool;
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+void CModBundleIndexSnapshot::ExportIndex(CModBundleIndex& index) const
+{
+    for(uint32_t i=0; i < NumOfRecords; i++){
+        CSmallString build_id(Pool + Records[i].BuildOffset);
+        index.Hashes[build_id] = EncodeSHA1(Records[i].SHA1);
+        index.Paths[build_id] = CFileName(Pool + Records[i].PathOffset);
+    }
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CModBundleIndexSnapshot::SaveSnapshot(const CModBundleIndex& index,const CFileName& index_name)
+{
+    string data;
+    if( BuildSnapshot(index,data) == false ) return(false);
+
+    if( index_name == "-" ){
+        cout.write(data.data(),data.size());
+        cout.flush();
+        if( ! cout ){
+            ES_ERROR("The index was not saved due to error!");
+            return(false);
+        }
+        return(true);
+    }
+
+    // mapped snapshots must never be modified in place
+    CFileName tmp_name = index_name + ".tmp";
+    ofstream ofs(tmp_name,ios::out | ios::binary | ios::trunc);
+    ofs.write(data.data(),data.size());
+    ofs.close();
+    if( ! ofs ){
+        CSmallString error;
+        error << "unable to open the index file '" << tmp_name << "' for writing!";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    if( rename(tmp_name,index_name) != 0 ){
+        CSmallString error;
+        error << "unable to rename '" << tmp_name << "' to '" << index_name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundleIndexSnapshot::IsSnapshot(const CFileName& index_name)
+{
+    ifstream ifs(index_name,ios::in | ios::binary);
+    char magic[sizeof(SnapshotMagic)];
+    if( ! ifs.read(magic,sizeof(magic)) ) return(false);
+    return( memcmp(magic,SnapshotMagic,sizeof(SnapshotMagic)) == 0 );
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundleIndexSnapshot::BuildSnapshot(const CModBundleIndex& index,std::string& data)
+{
+    vector<SRecord> records;
+    records.reserve(index.Paths.size());
+    string          pool;
+
+    map<CSmallString,CFileName>::const_iterator it = index.Paths.begin();
+    map<CSmallString,CFileName>::const_iterator ie = index.Paths.end();
+
+    while( it != ie ){
+        const char* p_build = it->first;
+        const char* p_path = it->second;
+        if( p_build == NULL ) p_build = "";
+        if( p_path == NULL ) p_path = "";
+
+        SRecord rec;
+        memset(&rec,0,sizeof(rec));
+
+        map<CSmallString,string>::const_iterator hit = index.Hashes.find(it->first);
+        if( (hit == index.Hashes.end()) || (DecodeSHA1(hit->second,rec.SHA1) == false) ){
+            CSmallString error;
+            error << "invalid SHA1 for the build '" << it->first << "' in the index '" << index.IndexFile << "'";
+            ES_ERROR(error);
+            return(false);
+        }
+
+        rec.BuildLength = strlen(p_build);
+        rec.BuildHash   = GetBuildHash(p_build,rec.BuildLength);
+        rec.BuildOffset = pool.size();
+        pool.append(p_build,rec.BuildLength);
+        pool.push_back('\0');
+
+        rec.PathLength  = strlen(p_path);
+        rec.PathOffset  = pool.size();
+        pool.append(p_path,rec.PathLength);
+        pool.push_back('\0');
+
+        records.push_back(rec);
+        it++;
+    }
+
+    if( pool.size() > UINT32_MAX ){
+        CSmallString error;
+        error << "the index '" << index.IndexFile << "' is too large for the snapshot";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    // the same order is used by Diff and CompareRecords - the order of the text index
+    const char* p_pool = pool.c_str();
+    sort(records.begin(),records.end(),[p_pool](const SRecord& left,const SRecord& right){
+        return( strcmp(p_pool + left.BuildOffset,p_pool + right.BuildOffset) < 0 );
+    });
+
+    SHeader header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.Magic,SnapshotMagic,sizeof(SnapshotMagic));
+    header.Version      = SnapshotVersion;
+    header.NumOfRecords = records.size();
+    header.PoolSize     = pool.size();
+
+    data.clear();
+    data.reserve(sizeof(SHeader) + records.size()*sizeof(SRecord) + pool.size());
+    data.append(reinterpret_cast<const char*>(&header),sizeof(header));
+    if( records.empty() == false ){
+        data.append(reinterpret_cast<const char*>(&records[0]),records.size()*sizeof(SRecord));
+    }
+    data.append(pool);
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+int CModBundleIndexSnapshot::GetNumOfEntries(void) const
+{
+    return(NumOfRecords);
+}
+
+//------------------------------------------------------------------------------
+
+void CModBundleIndexSnapshot::Diff(const CModBundleIndexSnapshot& old_index, CVerboseStr& vout,
+                                   bool skip_removed, bool skip_added, bool verbose) const
+{
+    if( verbose ) {
+        vout << endl;
+        vout << "# Diffing two indexes ..." << endl;
+    }
+
+    vout << low;
+
+    uint32_t i,j;
+
+    if( skip_removed == false ){
+
+        // determine removed entries (-)
+        i = 0;
+        j = 0;
+        while( j < old_index.NumOfRecords ){
+            int cmp = 1;
+            if( i < NumOfRecords ) cmp = CompareRecords(*this,Records[i],old_index,old_index.Records[j]);
+            if( cmp < 0 ){
+                i++;
+                continue;
+            }
+            if( cmp > 0 ){
+                old_index.PrintRecord(vout,'-',old_index.Records[j]);
+            } else {
+                i++;
+            }
+            j++;
+        }
+    }
+
+    // determine new entries (+) or modified (M)
+    i = 0;
+    j = 0;
+    while( i < NumOfRecords ){
+        int cmp = -1;
+        if( j < old_index.NumOfRecords ) cmp = CompareRecords(*this,Records[i],old_index,old_index.Records[j]);
+        if( cmp > 0 ){
+            j++;
+            continue;
+        }
+        if( cmp < 0 ){
+            if( skip_added == false ){
+                PrintRecord(vout,'+',Records[i]);
+            }
+        } else {
+            if( memcmp(Records[i].SHA1,old_index.Records[j].SHA1,sizeof(Records[i].SHA1)) != 0 ){
+                PrintRecord(vout,'M',Records[i]);
+            }
+            j++;
+        }
+        i++;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+int CModBundleIndexSnapshot::CompareRecords(const CModBundleIndexSnapshot& left,const SRecord& lrec,
+                                            const CModBundleIndexSnapshot& right,const SRecord& rrec)
+{
+    // equal hashes and lengths are required for the same build ID
+    if( (lrec.BuildHash == rrec.BuildHash) && (lrec.BuildLength == rrec.BuildLength) &&
+        (memcmp(left.Pool + lrec.BuildOffset,right.Pool + rrec.BuildOffset,lrec.BuildLength) == 0) ) return(0);
+    return( strcmp(left.Pool + lrec.BuildOffset,right.Pool + rrec.BuildOffset) );
+}
+
+//------------------------------------------------------------------------------
+
+void CModBundleIndexSnapshot::PrintRecord(CVerboseStr& vout,char flag,const SRecord& rec) const
+{
+    vout << flag << " " << EncodeSHA1(rec.SHA1) << " " << left << setw(50) << (Pool + rec.BuildOffset);
+    vout << " " << (Pool + rec.PathOffset) << endl;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+uint64_t CModBundleIndexSnapshot::GetBuildHash(const char* p_build,size_t len)
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i=0; i < len; i++){
+        hash ^= (unsigned char)p_build[i];
+        hash *= 1099511628211ULL;
+    }
+    return(hash);
+}
+
+//------------------------------------------------------------------------------
+
+bool CModBundleIndexSnapshot::DecodeSHA1(const std::string& sha1,uint8_t* p_bin)
+{
+    if( sha1.size() != 40 ) return(false);
+    for(int i=0; i < 40; i++){
+        int  digit;
+        char c = sha1[i];
+        if( (c >= '0') && (c <= '9') ){
+            digit = c - '0';
+        } else if( (c >= 'a') && (c <= 'f') ){
+            digit = c - 'a' + 10;
+        } else if( (c >= 'A') && (c <= 'F') ){
+            digit = c - 'A' + 10;
+        } else {
+            return(false);
+        }
+        if( i % 2 == 0 ){
+            p_bin[i/2] = digit << 4;
+        } else {
+            p_bin[i/2] |= digit;
+        }
+    }
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+const std::string CModBundleIndexSnapshot::EncodeSHA1(const uint8_t* p_bin)
+{
+    static const char digits[] = "0123456789abcdef";
+    string sha1(40,'0');
+    for(int i=0; i < 20; i++){
+        sha1[2*i]   = digits[p_bin[i] >> 4];
+        sha1[2*i+1] = digits[p_bin[i] & 0x0f];
+    }
+    return(sha1);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,122 @@
+#ifndef ModBundleIndexSnapshotH
+#define ModBundleIndexSnapshotH
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <FileName.hpp>
+#include <VerboseStr.hpp>
+#include <string>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+class CModBundleIndex;
+
+//------------------------------------------------------------------------------
+
+/// read-only binary index snapshot
+/// the snapshot is a table of fixed-width records sorted by build ID
+/// followed by a string pool with build IDs and paths, the snapshot is mapped
+/// into the memory and two snapshots are diffed by walking both tables
+/// the hash of build ID only speeds up the equality test
+/// the snapshot is in the native byte order, it is not portable among architectures
+
+class AMS_PACKAGE CModBundleIndexSnapshot {
+public:
+// constructor and destructor --------------------------------------------------
+    CModBundleIndexSnapshot(void);
+    ~CModBundleIndexSnapshot(void);
+
+// input methods ---------------------------------------------------------------
+    /// open index - snapshots are mapped, text indexes are converted in the memory
+    bool OpenIndex(const CFileName& index_name);
+
+    /// close index
+    void Close(void);
+
+    /// copy all entries into the index
+    void ExportIndex(CModBundleIndex& index) const;
+
+// output methods --------------------------------------------------------------
+    /// save index as a snapshot
+    static bool SaveSnapshot(const CModBundleIndex& index,const CFileName& index_name);
+
+    /// is the file a snapshot?
+    static bool IsSnapshot(const CFileName& index_name);
+
+// information methods ---------------------------------------------------------
+    /// number of entries
+    int GetNumOfEntries(void) const;
+
+    /// diff two snapshots
+    void Diff(const CModBundleIndexSnapshot& old_index, CVerboseStr& vout,
+              bool skip_removed, bool skip_added, bool verbose) const;
+
+// section of private data -----------------------------------------------------
+private:
+    struct SHeader {
+        char        Magic[8];
+        uint32_t    Version;
+        uint32_t    NumOfRecords;
+        uint64_t    PoolSize;
+    };
+
+    struct SRecord {
+        uint64_t    BuildHash;      // hash of build ID, for fast equality test
+        uint32_t    BuildOffset;    // offset into the pool
+        uint32_t    BuildLength;
+        uint32_t    PathOffset;     // offset into the pool
+        uint32_t    PathLength;
+        uint8_t     SHA1[20];
+        uint32_t    Reserved;
+    };
+
+    CFileName       IndexFile;
+    void*           MapAddr;
+    size_t          MapSize;
+    std::string     Buffer;         // converted text index
+    const SRecord*  Records;
+    uint32_t        NumOfRecords;
+    const char*     Pool;
+
+    /// set tables from data, check their consistency
+    bool SetData(const char* p_data,size_t size);
+
+    /// build snapshot from the index
+    static bool BuildSnapshot(const CModBundleIndex& index,std::string& data);
+
+    /// compare two records
+    static int CompareRecords(const CModBundleIndexSnapshot& left,const SRecord& lrec,
+                              const CModBundleIndexSnapshot& right,const SRecord& rrec);
+
+    /// print one diff line
+    void PrintRecord(CVerboseStr& vout,char flag,const SRecord& rec) const;
+
+    // helpers
+    static uint64_t GetBuildHash(const char* p_build,size_t len);
+    static bool DecodeSHA1(const std::string& sha1,uint8_t* p_bin);
+    static const std::string EncodeSHA1(const uint8_t* p_bin);
+};
+
+//-----------------------------------------------------------------------------
+
+#endif
@@ -30,6 +30,10 @@
 #include <XMLComment.hpp>
 #include <ModUtils.hpp>
 #include <User.hpp>
+#include <ModCacheReader.hpp>
+#include <set>
+#include <algorithm>
+#include <string>
 
 //------------------------------------------------------------------------------
 
@@ -83,13 +87,266 @@ bool sort_tokens(const CPVerRecord& left,const CPVerRecord& right)
     return(true);
 }
 
+//------------------------------------------------------------------------------
+
+static void SplitAvailList(const char* p_str,std::vector<std::string>& list)
+{
+    if( p_str == NULL ) return;
+    const char* p_beg = p_str;
+    while( *p_beg != '\0' ){
+        const char* p_end = strchr(p_beg,',');
+        if( p_end == NULL ) p_end = p_beg + strlen(p_beg);
+        if( p_end != p_beg ) list.push_back(std::string(p_beg,p_end-p_beg));
+        if( *p_end == '\0' ) break;
+        p_beg = p_end + 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// get module builds in the version order
+// builds are already sorted in caches created with the version index
+// TElement is either CXMLElement or const CROXMLElement
+template<class TElement>
+static void GetBuildRecordsSorted(TElement* p_mele,std::list<CPVerRecord>& pvlist)
+{
+    TElement*  p_bele = p_mele->GetChildElementByPath("builds/build");
+
+    while( p_bele != NULL ) {
+        CPVerRecord bldrcd;
+        bldrcd.verindx = 0.0;
+        p_bele->GetAttribute("ver",bldrcd.ver);
+        p_bele->GetAttribute("arch",bldrcd.arch);
+        p_bele->GetAttribute("mode",bldrcd.mode);
+        p_bele->GetAttribute("verindx",bldrcd.verindx);
+        if( (bldrcd.ver != NULL) && (bldrcd.arch != NULL) && (bldrcd.mode != NULL) ){
+            pvlist.push_back(bldrcd);
+        }
+        p_bele = p_bele->GetNextSiblingElement("build");
+    }
+
+    if( p_mele->GetFirstChildElement("versions") == NULL ){
+        // old cache
+        pvlist.sort(sort_tokens);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// TElement is either CXMLElement or const CROXMLElement
+template<class TElement>
+static void AddModuleToAvail(TElement* p_mele,bool includever,
+                             std::map<std::string, std::set<std::string> >& cats,
+                             std::set<std::string>& sysmods,int& len)
+{
+    CSmallString modname;
+    p_mele->GetAttribute("name",modname);
+    if( modname == NULL ) return;
+
+    std::vector<std::string> mcats;
+    std::vector<std::string> mvers;
+    int width = 0;
+
+    TElement* p_aele = p_mele->GetFirstChildElement("avail");
+    if( p_aele != NULL ){
+        // precomputed by bundle cache rebuild
+        CSmallString scats,svers;
+        p_aele->GetAttribute("cats",scats);
+        p_aele->GetAttribute("vers",svers);
+        SplitAvailList(scats,mcats);
+        if( includever ){
+            SplitAvailList(svers,mvers);
+            p_aele->GetAttribute("vwidth",width);
+        } else {
+            p_aele->GetAttribute("width",width);
+        }
+    } else {
+        // old cache - scan categories and builds
+        TElement* p_dele = p_mele->GetChildElementByPath("categories/category");
+        while( p_dele != NULL ) {
+            CSmallString cname;
+            p_dele->GetAttribute("name",cname);
+            if( cname != NULL ) mcats.push_back(std::string(cname));
+            p_dele = p_dele->GetNextSiblingElement("category");
+        }
+        if( includever ){
+            TElement* p_bele = p_mele->GetChildElementByPath("builds/build");
+            while( p_bele != NULL ) {
+                CSmallString modver;
+                p_bele->GetAttribute("ver",modver);
+                if( modver != NULL ){
+                    mvers.push_back(std::string(modver));
+                    int vlen = modname.GetLength() + 1 + modver.GetLength();
+                    if( vlen > width ) width = vlen;
+                }
+                p_bele = p_bele->GetNextSiblingElement("build");
+            }
+        } else {
+            width = modname.GetLength();
+        }
+    }
+
+    if( width > len ) len = width;
+
+    std::set<std::string>* p_none = NULL;
+    if( mcats.empty() ) p_none = &sysmods;
+
+    for(size_t i=0; i <= mcats.size(); i++){
+        std::set<std::string>* p_set = p_none;
+        if( i < mcats.size() ){
+            p_set = &cats[mcats[i]];
+        }
+        if( p_set == NULL ) continue;
+        if( includever ){
+            for(const std::string& ver : mvers){
+                p_set->insert(std::string(modname) + ":" + ver);
+            }
+        } else {
+            p_set->insert(std::string(modname));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class TElement>
+static void AddModuleDPKGDeps(TElement* p_mele,std::list<CSmallString>& list)
+{
+    TElement* p_dep = p_mele->GetChildElementByPath("builds/build/deps/dep");
+    while( p_dep != NULL ) {
+        CSmallString name;
+        p_dep->GetAttribute("name",name);
+        CSmallString type;
+        p_dep->GetAttribute("type",type);
+        if( type == "deb" ){
+            list.push_back(name);
+        }
+        p_dep = p_dep->GetNextSiblingElement("dep");
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class TElement>
+static void AddModuleCategories(TElement* p_mele,std::list<CSmallString>& list)
+{
+    TElement*  p_dele = p_mele->GetChildElementByPath("categories/category");
+    // support multiple categories
+    while( p_dele != NULL ) {
+        CSmallString cname;
+        p_dele->GetAttribute("name",cname);
+        if( cname != NULL ) list.push_back(cname);
+        p_dele = p_dele->GetNextSiblingElement("category");
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class TElement>
+static void AddModuleVersions(TElement* p_mele,const CSmallString& modname,
+                              std::list<CSmallString>& list)
+{
+    TElement*  p_bele = p_mele->GetChildElementByPath("builds/build");
+    while( p_bele != NULL ) {
+        CSmallString modver;
+        p_bele->GetAttribute("ver",modver);
+        if( modver != NULL ){
+            CSmallString module;
+            module << modname << ":" << modver;
+            list.push_back(module);
+        }
+        p_bele = p_bele->GetNextSiblingElement("build");
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class TElement>
+static void AddModuleInCategory(TElement* p_mele,const CSmallString& category,
+                                std::list<CSmallString>& list,bool includever)
+{
+    bool include = false;
+    bool hascat  = false;
+
+    TElement*  p_dele = p_mele->GetChildElementByPath("categories/category");
+    while( p_dele != NULL ){
+        CSmallString cname;
+        p_dele->GetAttribute("name",cname);
+        hascat = true;
+        if( category == cname ) {
+            include = true;
+            break;
+        }
+        p_dele = p_dele->GetNextSiblingElement("category");
+    }
+
+    if( hascat == false ){
+        if( category == "sys" ){
+            include = true;
+        }
+    }
+
+    if( include == false ) return;
+
+    CSmallString modname;
+    p_mele->GetAttribute("name",modname);
+    if( modname == NULL ) return;
+
+    if( includever ) {
+        // sorting does not have an effect as the whole list is sorted later
+        AddModuleVersions(p_mele,modname,list);
+    } else {
+        list.push_back(modname);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class TElement>
+static void AddModuleBuilds(TElement* p_mele,std::list<CSmallString>& list)
+{
+    CSmallString name;
+    p_mele->GetAttribute("name",name);
+
+    std::list<CPVerRecord>  pvlist;
+    GetBuildRecordsSorted(p_mele,pvlist);
+
+    // do not call unique as it makes it unique per version!!
+
+    for(CPVerRecord pvrec : pvlist){
+        CSmallString build;
+        build << name << ":" << pvrec.ver << ":" << pvrec.arch << ":" << pvrec.mode;
+        list.push_back(build);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+template<class TElement>
+static void UpdateModulePrintSize(TElement* p_mele,bool includever,size_t& len)
+{
+    CSmallString modname;
+    p_mele->GetAttribute("name",modname);
+    if( modname == NULL ) return;
+
+    if( includever ) {
+        std::list<CSmallString> mods;
+        AddModuleVersions(p_mele,modname,mods);
+        for(CSmallString module : mods){
+            if( module.GetLength() > len ) len = module.GetLength();
+        }
+    } else {
+        if( modname.GetLength() > len ) len = modname.GetLength();
+    }
+}
+
 //==============================================================================
 //------------------------------------------------------------------------------
 //==============================================================================
 
 CModCache::CModCache(void)
 {
-
+    ReadOnly = false;
 }
 
 //==============================================================================
@@ -99,6 +356,7 @@ CModCache::CModCache(void)
 bool CModCache::LoadCacheFile(const CFileName& name)
 {
     Cache.RemoveAllChildNodes();
+    ClearReadOnlyData();
 
     if( CFileSystem::IsFile(name) == false ){
         CSmallString error;
@@ -154,6 +412,49 @@ bool CModCache::SaveCacheFile(const CFileName& name)
 
 //------------------------------------------------------------------------------
 
+bool CModCache::LoadReadOnlyCacheFile(const CFileName& name)
+{
+    Cache.RemoveAllChildNodes();
+    ClearReadOnlyData();
+
+    if( CFileSystem::IsFile(name) == false ){
+        CSmallString error;
+        error << "no module cache file yet: '" << name << "'";
+        ES_WARNING(error);
+        return(false);
+    }
+
+    if( ROCache.Load(name) == false ) {
+        CSmallString error;
+        error << "unable to parse module cache file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    const CROXMLElement* p_cele = ROCache.GetFirstChildElement("cache");
+    if( p_cele == NULL ){
+        CSmallString error;
+        error << "unable to open cache element in '" << name << "'";
+        ES_ERROR(error);
+        ROCache.Clear();
+        return(false);
+    }
+
+    // materialized modules are placed here
+    Cache.CreateChildElement("cache");
+    ReadOnly = true;
+
+    const CROXMLElement* p_mele = p_cele->GetFirstChildElement("module");
+    while( p_mele != NULL ) {
+        AddReadOnlyModule(p_mele,NULL);
+        p_mele = p_mele->GetNextSiblingElement("module");
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
 bool CModCache::SaveSourceFile(const CFileName& name)
 {
     bool result = false;
@@ -274,6 +575,70 @@ CXMLElement* CModCache::GetCacheElement(void)
 
 //------------------------------------------------------------------------------
 
+bool CModCache::IsReadOnly(void) const
+{
+    return(ReadOnly);
+}
+
+//------------------------------------------------------------------------------
+
+const CROXMLElement* CModCache::GetReadOnlyCacheElement(void) const
+{
+    return( ROCache.GetFirstChildElement("cache") );
+}
+
+//------------------------------------------------------------------------------
+
+void CModCache::AddReadOnlyModule(const CROXMLElement* p_mele,CXMLElement* p_origin)
+{
+    const char* p_name = p_mele->GetAttributeValue("name");
+    if( p_name == NULL ) return;
+
+    SROModule rec;
+    rec.Module = p_mele;
+    rec.Origin = p_origin;
+    rec.Materialized = NULL;
+
+    if( ROModuleIndex.insert(TROModuleIndex::value_type(p_name,ROModules.size())).second ){
+        ROModules.push_back(rec);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+const CROXMLElement* CModCache::FindReadOnlyModule(const CSmallString& name) const
+{
+    if( name == NULL ) return(NULL);
+    TROModuleIndex::const_iterator it = ROModuleIndex.find((const char*)name);
+    if( it == ROModuleIndex.end() ) return(NULL);
+    return( ROModules[it->second].Module );
+}
+
+//------------------------------------------------------------------------------
+
+CXMLElement* CModCache::MaterializeModule(SROModule& rec)
+{
+    if( rec.Materialized != NULL ) return(rec.Materialized);
+
+    rec.Materialized = rec.Module->CopyToXMLNode(GetCacheElement());
+    if( rec.Origin ){
+        rec.Origin->DuplicateNode(rec.Materialized);
+    }
+    return(rec.Materialized);
+}
+
+//------------------------------------------------------------------------------
+
+void CModCache::ClearReadOnlyData(void)
+{
+    ReadOnly = false;
+    ROModules.clear();
+    ROModuleIndex.clear();
+    ROCache.Clear();
+}
+
+//------------------------------------------------------------------------------
+
 CXMLElement* CModCache::GetModule(const CSmallString& name,bool create)
 {
     CXMLElement* p_cele = Cache.GetFirstChildElement("cache");
@@ -283,6 +648,15 @@ CXMLElement* CModCache::GetModule(const CSmallString& name,bool create)
 
     CSmallString modname = CModUtils::GetModuleName(name);
 
+    if( IsReadOnly() ){
+        TROModuleIndex::iterator it = ROModuleIndex.find((const char*)modname);
+        if( it != ROModuleIndex.end() ) return( MaterializeModule(ROModules[it->second]) );
+        if( create ){
+            LOGIC_ERROR("modules cannot be created in the read-only cache");
+        }
+        return(NULL);
+    }
+
     CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
     while( p_mele != NULL ) {
         CSmallString lname;
@@ -304,6 +678,10 @@ CXMLElement* CModCache::GetModule(const CSmallString& name,bool create)
 
 CXMLElement* CModCache::CreateModule(const CSmallString& name)
 {
+    if( IsReadOnly() ){
+        LOGIC_ERROR("modules cannot be created in the read-only cache");
+    }
+
     CXMLElement* p_cele = Cache.GetFirstChildElement("cache");
     if( p_cele == NULL ){
         RUNTIME_ERROR("unable to open cache element");
@@ -386,6 +764,18 @@ void CModCache::GetModuleVersions(CXMLElement* p_mele, std::list<CSmallString>&
 
 void CModCache::GetModuleVersionsSorted(CXMLElement* p_mele, std::list<CSmallString>& list)
 {
+    // use version index if available
+    CXMLElement*  p_vele = p_mele->GetChildElementByPath("versions/version");
+    if( p_vele != NULL ){
+        while( p_vele != NULL ) {
+            CSmallString modver;
+            p_vele->GetAttribute("ver",modver);
+            if( modver != NULL ) list.push_back(modver);
+            p_vele = p_vele->GetNextSiblingElement("version");
+        }
+        return;
+    }
+
     CXMLElement*  p_bele = p_mele->GetChildElementByPath("builds/build");
 
     std::list<CPVerRecord>  pvlist;
@@ -417,27 +807,10 @@ void CModCache::GetModuleBuildsSorted(CXMLElement* p_mele, std::list<CSmallStrin
     CSmallString name;
     p_mele->GetAttribute("name",name);
 
-    CXMLElement*  p_bele = p_mele->GetChildElementByPath("builds/build");
-
     std::list<CPVerRecord>  pvlist;
-
-    while( p_bele != NULL ) {
-        CPVerRecord bldrcd;
-        bldrcd.verindx = 0.0;
-        p_bele->GetAttribute("ver",bldrcd.ver);
-        p_bele->GetAttribute("arch",bldrcd.arch);
-        p_bele->GetAttribute("mode",bldrcd.mode);
-        p_bele->GetAttribute("verindx",bldrcd.verindx);
-        if( (bldrcd.ver != NULL) && (bldrcd.arch != NULL) && (bldrcd.mode != NULL) ){
-            pvlist.push_back(bldrcd);
-        }
-        p_bele = p_bele->GetNextSiblingElement("build");
-    }
-
-    pvlist.sort(sort_tokens);
+    GetBuildRecordsSorted(p_mele,pvlist);
 
     // do not call unique as it makes it unique per version!!
-    // pvlist.unique();
 
     for(CPVerRecord pvrec : pvlist){
         CSmallString build;
@@ -457,27 +830,10 @@ void CModCache::GetModuleBuildsSorted(CXMLElement* p_mele, const CSmallString& v
     CSmallString name;
     p_mele->GetAttribute("name",name);
 
-    CXMLElement*  p_bele = p_mele->GetChildElementByPath("builds/build");
-
     std::list<CPVerRecord>  pvlist;
-
-    while( p_bele != NULL ) {
-        CPVerRecord bldrcd;
-        bldrcd.verindx = 0.0;
-        p_bele->GetAttribute("ver",bldrcd.ver);
-        p_bele->GetAttribute("arch",bldrcd.arch);
-        p_bele->GetAttribute("mode",bldrcd.mode);
-        p_bele->GetAttribute("verindx",bldrcd.verindx);
-        if( (bldrcd.ver != NULL) && (bldrcd.arch != NULL) && (bldrcd.mode != NULL) ){
-            pvlist.push_back(bldrcd);
-        }
-        p_bele = p_bele->GetNextSiblingElement("build");
-    }
-
-    pvlist.sort(sort_tokens);
+    GetBuildRecordsSorted(p_mele,pvlist);
 
     // do not call unique as it makes it unique per version!!
-    // pvlist.unique();
 
     for(CPVerRecord pvrec : pvlist){
         if( pvrec.ver == vers ){
@@ -493,6 +849,107 @@ void CModCache::GetModuleBuildsSorted(CXMLElement* p_mele, const CSmallString& v
 
 //------------------------------------------------------------------------------
 
+void CModCache::SortModuleBuilds(CXMLElement* p_mele)
+{
+    if( p_mele == NULL ) return;
+
+    CXMLElement* p_vsele = p_mele->GetFirstChildElement("versions");
+    if( p_vsele != NULL ) delete p_vsele;
+
+    CXMLElement* p_builds = p_mele->GetFirstChildElement("builds");
+    if( p_builds == NULL ) return;
+
+    std::vector<std::pair<CPVerRecord,CXMLElement*> > builds;
+
+    CXMLElement* p_bele = p_builds->GetFirstChildElement("build");
+    while( p_bele != NULL ) {
+        CPVerRecord bldrcd;
+        bldrcd.verindx = 0.0;
+        p_bele->GetAttribute("ver",bldrcd.ver);
+        p_bele->GetAttribute("verindx",bldrcd.verindx);
+        builds.push_back(std::make_pair(bldrcd,p_bele));
+        p_bele = p_bele->GetNextSiblingElement("build");
+    }
+
+    // the same order as in the previous on demand sorting
+    std::stable_sort(builds.begin(),builds.end(),
+                     [](const std::pair<CPVerRecord,CXMLElement*>& left,
+                        const std::pair<CPVerRecord,CXMLElement*>& right){
+                        return( sort_tokens(left.first,right.first) );
+                     });
+
+    // sorted builds and version index
+    CXMLElement* p_sorted = p_mele->CreateChildElement("builds");
+    CXMLElement* p_vindex = p_mele->CreateChildElement("versions");
+
+    CSmallString lastver;
+    for(std::pair<CPVerRecord,CXMLElement*>& bld : builds){
+        if( bld.second->DuplicateNode(p_sorted) == NULL ){
+            RUNTIME_ERROR("unable to duplicate build");
+        }
+        if( (bld.first.ver != NULL) && (bld.first.ver != lastver) ){
+            CXMLElement* p_vele = p_vindex->CreateChildElement("version");
+            p_vele->SetAttribute("ver",bld.first.ver);
+            p_vele->SetAttribute("verindx",bld.first.verindx);
+            lastver = bld.first.ver;
+        }
+    }
+
+    delete p_builds;
+}
+
+//------------------------------------------------------------------------------
+
+void CModCache::UpdateModuleAvail(CXMLElement* p_mele)
+{
+    if( p_mele == NULL ) return;
+
+    CXMLElement* p_aele = p_mele->GetFirstChildElement("avail");
+    if( p_aele != NULL ) delete p_aele;
+
+    CSmallString modname;
+    p_mele->GetAttribute("name",modname);
+
+    std::list<CSmallString> cats;
+    CXMLElement* p_dele = p_mele->GetChildElementByPath("categories/category");
+    while( p_dele != NULL ) {
+        CSmallString cname;
+        p_dele->GetAttribute("name",cname);
+        if( cname != NULL ) cats.push_back(cname);
+        p_dele = p_dele->GetNextSiblingElement("category");
+    }
+    cats.sort();
+    cats.unique();
+
+    std::list<CSmallString> vers;
+    GetModuleVersions(p_mele,vers);
+    vers.sort();
+    vers.unique();
+
+    CSmallString scats;
+    for(CSmallString cat : cats){
+        if( scats != NULL ) scats << ",";
+        scats << cat;
+    }
+
+    CSmallString svers;
+    int vwidth = 0;
+    for(CSmallString ver : vers){
+        if( svers != NULL ) svers << ",";
+        svers << ver;
+        int len = modname.GetLength() + 1 + ver.GetLength();
+        if( len > vwidth ) vwidth = len;
+    }
+
+    p_aele = p_mele->CreateChildElement("avail");
+    p_aele->SetAttribute("cats",scats);
+    p_aele->SetAttribute("vers",svers);
+    p_aele->SetAttribute("width",(int)modname.GetLength());
+    p_aele->SetAttribute("vwidth",vwidth);
+}
+
+//------------------------------------------------------------------------------
+
 bool CModCache::CanModuleBeExported(CXMLElement* p_mele)
 {
     if( p_mele == NULL ) return(true);
@@ -659,21 +1116,16 @@ void CModCache::GetDPKGDeps(std::list<CSmallString>& list)
         return;
     }
 
+    if( IsReadOnly() ){
+        for(const SROModule& rec : ROModules){
+            AddModuleDPKGDeps(rec.Module,list);
+        }
+        return;
+    }
+
     CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
     while( p_mele != NULL ) {
-        CSmallString name;
-        p_mele->GetAttribute("name",name);
-        CXMLElement* p_dep = p_mele->GetChildElementByPath("builds/build/deps/dep");
-        while( p_dep != NULL ) {
-            CSmallString name;
-            p_dep->GetAttribute("name",name);
-            CSmallString type;
-            p_dep->GetAttribute("type",type);
-            if( type == "deb" ){
-                list.push_back(name);
-            }
-            p_dep = p_dep->GetNextSiblingElement("dep");
-        }
+        AddModuleDPKGDeps(p_mele,list);
         p_mele = p_mele->GetNextSiblingElement("module");
     }
 }
@@ -688,18 +1140,16 @@ void CModCache::GetCategories(std::list<CSmallString>& list)
         return;
     }
 
-    CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
-    while( p_mele != NULL ) {
-
-        CXMLElement*  p_dele = p_mele->GetChildElementByPath("categories/category");
-        // support multiple categories
-        while( p_dele != NULL ) {
-            CSmallString cname;
-            p_dele->GetAttribute("name",cname);
-            if( cname != NULL ) list.push_back(cname);
-            p_dele = p_dele->GetNextSiblingElement("category");
+    if( IsReadOnly() ){
+        for(const SROModule& rec : ROModules){
+            AddModuleCategories(rec.Module,list);
         }
+        return;
+    }
 
+    CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
+    while( p_mele != NULL ) {
+        AddModuleCategories(p_mele,list);
         p_mele = p_mele->GetNextSiblingElement("module");
     }
 }
@@ -714,48 +1164,16 @@ void CModCache::GetModules(const CSmallString& category, std::list<CSmallString>
         return;
     }
 
-    CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
-    while( p_mele != NULL ) {
-        bool include = false;
-        bool hascat  = false;
-
-        CXMLElement*  p_dele = p_mele->GetChildElementByPath("categories/category");
-        while( p_dele != NULL ){
-            CSmallString cname;
-            p_dele->GetAttribute("name",cname);
-            hascat = true;
-            if( category == cname ) {
-                include = true;
-                break;
-            }
-            p_dele = p_dele->GetNextSiblingElement("category");
-        }
-
-        if( hascat == false ){
-            if( category == "sys" ){
-                include = true;
-            }
-        }
-
-        if( include ){
-            CSmallString modname;
-            p_mele->GetAttribute("name",modname);
-            if( modname != NULL ){
-                if( includever ) {
-                    std::list<CSmallString> vers;
-                    // sorting does not have an effect as the whole list is sorted later
-                    GetModuleVersions(p_mele,vers);
-                    for(CSmallString modver : vers){
-                        CSmallString module;
-                        module << modname << ":" << modver;
-                        list.push_back(module);
-                    }
-                } else {
-                    list.push_back(modname);
-                }
-            }
+    if( IsReadOnly() ){
+        for(const SROModule& rec : ROModules){
+            AddModuleInCategory(rec.Module,category,list,includever);
         }
+        return;
+    }
 
+    CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
+    while( p_mele != NULL ) {
+        AddModuleInCategory(p_mele,category,list,includever);
         p_mele = p_mele->GetNextSiblingElement("module");
     }
 }
@@ -770,6 +1188,13 @@ void CModCache::GetModules(std::list<CSmallString>& list)
         return;
     }
 
+    if( IsReadOnly() ){
+        for(const SROModule& rec : ROModules){
+            list.push_back(rec.Module->GetAttributeValue("name"));
+        }
+        return;
+    }
+
     CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
     while( p_mele != NULL ) {
         CSmallString modname;
@@ -789,9 +1214,16 @@ void CModCache::GetBuilds(std::list<CSmallString>& list)
         return;
     }
 
+    if( IsReadOnly() ){
+        for(const SROModule& rec : ROModules){
+            AddModuleBuilds(rec.Module,list);
+        }
+        return;
+    }
+
     CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
     while( p_mele != NULL ) {
-        GetModuleBuildsSorted(p_mele,list,true);
+        AddModuleBuilds(p_mele,list);
         p_mele = p_mele->GetNextSiblingElement("module");
     }
 }
@@ -808,26 +1240,16 @@ int CModCache::GetModulePrintSize(bool includever)
         return(len);
     }
 
-    CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
-    while( p_mele != NULL ) {
-        CSmallString modname;
-        p_mele->GetAttribute("name",modname);
-        if( modname != NULL ){
-            if( includever ) {
-                std::list<CSmallString> vers;
-                // sorting does not have an effect as the whole list is sorted later
-                GetModuleVersions(p_mele,vers);
-                for(CSmallString modver : vers){
-                    CSmallString module;
-                    module << modname << ":" << modver;
-                    if( module.GetLength() > len ) len = module.GetLength();
-                }
-            } else {
-                if( modname.GetLength() > len ) len = modname.GetLength();
-            }
+    if( IsReadOnly() ){
+        for(const SROModule& rec : ROModules){
+            UpdateModulePrintSize(rec.Module,includever,len);
+        }
+    } else {
+        CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
+        while( p_mele != NULL ) {
+            UpdateModulePrintSize(p_mele,includever,len);
+            p_mele = p_mele->GetNextSiblingElement("module");
         }
-
-        p_mele = p_mele->GetNextSiblingElement("module");
     }
     len++;
     return(len);
@@ -843,65 +1265,42 @@ void CModCache::GetBuildsForCGen(std::list<CSmallString>& list,int numparts)
         return;
     }
 
+    // completion is called for every key press - do not materialize modules
+    if( IsReadOnly() ){
+        for(const SROModule& rec : ROModules){
+            CSmallString name = rec.Module->GetAttributeValue("name");
+            AddBuildForCGen(list,numparts,name,"default","auto","auto");
+
+            const CROXMLElement* p_dele = rec.Module->GetChildElementByPath("builds/build");
+            while( p_dele != NULL ) {
+                CSmallString ver;
+                CSmallString arch;
+                CSmallString mode;
+                p_dele->GetAttribute("ver",ver);
+                p_dele->GetAttribute("arch",arch);
+                p_dele->GetAttribute("mode",mode);
+                AddBuildForCGen(list,numparts,name,ver,arch,mode);
+                p_dele = p_dele->GetNextSiblingElement("build");
+            }
+        }
+        return;
+    }
+
     CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
     while( p_mele != NULL ) {
-
         CSmallString name;
         p_mele->GetAttribute("name",name);
-
-        CSmallString suggestion;
-
-        switch(numparts) {
-        case 0:
-            suggestion = name;
-            break;
-        case 1:
-            suggestion = name + ":" + "default";
-            break;
-        case 2:
-            suggestion = name + ":" + "default" + ":" + "auto";
-            break;
-        case 3:
-            suggestion = name + ":" + "default" + ":" + "auto" + ":" + "auto";
-            break;
-        default:
-            break;
-        }
-
-        list.push_back(suggestion);
+        AddBuildForCGen(list,numparts,name,"default","auto","auto");
 
         CXMLElement*  p_dele = p_mele->GetChildElementByPath("builds/build");
         while( p_dele != NULL ) {
-
             CSmallString ver;
             CSmallString arch;
             CSmallString mode;
             p_dele->GetAttribute("ver",ver);
             p_dele->GetAttribute("arch",arch);
             p_dele->GetAttribute("mode",mode);
-
-            CSmallString suggestion;
-
-            // how many items from name should be printed?
-            switch(numparts) {
-            case 0:
-                suggestion = name;
-                break;
-            case 1:
-                suggestion = name + ":" + ver;
-                break;
-            case 2:
-                suggestion = name + ":" + ver + ":" + arch;
-                break;
-            case 3:
-                suggestion = name + ":" + ver + ":" + arch + ":" + mode;
-                break;
-            default:
-                break;
-            }
-
-            list.push_back(suggestion);
-
+            AddBuildForCGen(list,numparts,name,ver,arch,mode);
             p_dele = p_dele->GetNextSiblingElement("build");
         }
 
@@ -911,36 +1310,77 @@ void CModCache::GetBuildsForCGen(std::list<CSmallString>& list,int numparts)
 
 //------------------------------------------------------------------------------
 
+void CModCache::AddBuildForCGen(std::list<CSmallString>& list,int numparts,
+                                const CSmallString& name,const CSmallString& ver,
+                                const CSmallString& arch,const CSmallString& mode)
+{
+    CSmallString suggestion;
+
+    // how many items from name should be printed?
+    switch(numparts) {
+    case 0:
+        suggestion = name;
+        break;
+    case 1:
+        suggestion = name + ":" + ver;
+        break;
+    case 2:
+        suggestion = name + ":" + ver + ":" + arch;
+        break;
+    case 3:
+        suggestion = name + ":" + ver + ":" + arch + ":" + mode;
+        break;
+    default:
+        break;
+    }
+
+    list.push_back(suggestion);
+}
+
+//------------------------------------------------------------------------------
+
 void CModCache::PrintAvail(CTerminal& terminal,bool includever,bool includesys)
 {
-// get categories
-    std::list<CSmallString> cats;
-    GetCategories(cats);
-    cats.sort();
-    cats.unique();
+    CXMLElement* p_cele = Cache.GetFirstChildElement("cache");
+    if( p_cele == NULL ){
+        ES_WARNING("unable to open cache element, no bundles loaded?");
+        return;
+    }
 
-    int len = GetModulePrintSize(includever);
+// collect modules in a single pass
+    std::map<std::string, std::set<std::string> >  cats;
+    std::set<std::string>                           sysmods;
+    int                                             len = 0;
+
+    if( IsReadOnly() ){
+        // do not materialize modules, use precomputed data if available
+        for(const SROModule& rec : ROModules){
+            AddModuleToAvail(rec.Module,includever,cats,sysmods,len);
+        }
+    } else {
+        CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
+        while( p_mele != NULL ) {
+            AddModuleToAvail(p_mele,includever,cats,sysmods,len);
+            p_mele = p_mele->GetNextSiblingElement("module");
+        }
+    }
+    len++;
 
 // print modules
-    for(CSmallString cat : cats){
-        std::list<CSmallString> mods;
-        GetModules(cat,mods,includever);
-        mods.sort();
-        mods.unique();
-        if( mods.empty() ) continue;
-        PrintEngine.PrintHeader(terminal,cat,EPEHS_CATEGORY);
+    for(auto& cat : cats){
+        if( cat.first == "sys" ){
+            sysmods.insert(cat.second.begin(),cat.second.end());
+        }
+        if( cat.second.empty() ) continue;
+        std::list<CSmallString> mods(cat.second.begin(),cat.second.end());
+        PrintEngine.PrintHeader(terminal,cat.first.c_str(),EPEHS_CATEGORY);
         PrintEngine.PrintItems(terminal,mods,len);
     }
 
-    if( includesys ){
-        std::list<CSmallString> mods;
-        GetModules("sys",mods,includever);
-        mods.sort();
-        mods.unique();
-        if( ! mods.empty() ){
-            PrintEngine.PrintHeader(terminal,"System & Uncategorized Modules",EPEHS_CATEGORY);
-            PrintEngine.PrintItems(terminal,mods,len);
-        }
+    if( includesys && (! sysmods.empty()) ){
+        std::list<CSmallString> mods(sysmods.begin(),sysmods.end());
+        PrintEngine.PrintHeader(terminal,"System & Uncategorized Modules",EPEHS_CATEGORY);
+        PrintEngine.PrintItems(terminal,mods,len);
     }
 }
 
@@ -1077,6 +1517,9 @@ int CModCache::GetNumberOfModules(void)
         RUNTIME_ERROR("unable to open cache element");
     }
 
+    // module names are unique in the read-only index
+    if( IsReadOnly() ) return(ROModules.size());
+
     CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
     while( p_mele != NULL ) {
         CSmallString modname;
@@ -1134,9 +1577,48 @@ void CModCache::MergeWithCache(CXMLElement* p_bcele,CXMLElement* p_origin)
 
 //------------------------------------------------------------------------------
 
+void CModCache::MergeWithReadOnlyCache(const CROXMLElement* p_bcele,CXMLElement* p_origin)
+{
+    if( Cache.GetFirstChildElement("cache") == NULL ){
+        CreateEmptyCache();
+    }
+    if( p_bcele == NULL ){
+        RUNTIME_ERROR("p_bcache == NULL");
+    }
+    if( (IsReadOnly() == false) && (Cache.GetFirstChildElement("cache")->GetFirstChildElement("module") != NULL) ){
+        LOGIC_ERROR("read-only cache cannot be merged into the standard cache");
+    }
+    ReadOnly = true;
+
+    const CROXMLElement* p_bmele = p_bcele->GetFirstChildElement("module");
+    while( p_bmele != NULL ) {
+        AddReadOnlyModule(p_bmele,p_origin);
+        p_bmele = p_bmele->GetNextSiblingElement("module");
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool CModCache::MergeWithCacheFile(const CFileName& name,CXMLElement* p_origin)
+{
+    CXMLElement* p_lcele = Cache.GetFirstChildElement("cache");
+    if( p_lcele == NULL ){
+        p_lcele = CreateEmptyCache();
+    }
+    if( IsReadOnly() ){
+        LOGIC_ERROR("cache file cannot be merged into the read-only cache");
+    }
+
+    CModCacheReader reader;
+    return( reader.MergeCacheFile(name,p_lcele,p_origin) );
+}
+
+//------------------------------------------------------------------------------
+
 CXMLElement* CModCache::CreateEmptyCache(void)
 {
     Cache.RemoveAllChildNodes();
+    ClearReadOnlyData();
 
 // create header elements
     Cache.CreateChildDeclaration();
@@ -1187,6 +1669,33 @@ const CSmallString CModCache::GetVariableValue(CXMLElement* p_rele,
 
 bool CModCache::DoesItNeedGPU(const CSmallString& name)
 {
+    if( IsReadOnly() ){
+        const CROXMLElement* p_module = FindReadOnlyModule(CModUtils::GetModuleName(name));
+        if( p_module == NULL ){
+            CSmallString warning;
+            warning << "module '" << name << "'' was not found in the cache";
+            ES_WARNING(warning);
+            return(false);
+        }
+
+        const CROXMLElement* p_sele = p_module->GetChildElementByPath("builds/build");
+
+        bool gpu = false;
+        bool others = false;
+
+        while( p_sele != NULL ) {
+            const char* p_arch = p_sele->GetAttributeValue("arch");
+            if( (p_arch != NULL) && ((strstr(p_arch,"gpu") != NULL) || (strstr(p_arch,"cuda") != NULL)) ){
+                gpu = true;
+            } else {
+                others = true;
+            }
+            p_sele = p_sele->GetNextSiblingElement("build");
+        }
+
+        return(gpu && (others == false));
+    }
+
     CXMLElement* p_module = GetModule(name);
     if( p_module == NULL ){
         CSmallString warning;
@@ -1218,6 +1727,20 @@ bool CModCache::DoesItNeedGPU(const CSmallString& name)
 
 bool CModCache::IsAutoloadEnabled(const CSmallString& name)
 {
+    bool enabled = true;
+
+    if( IsReadOnly() ){
+        const CROXMLElement* p_module = FindReadOnlyModule(CModUtils::GetModuleName(name));
+        if( p_module == NULL ){
+            CSmallString warning;
+            warning << "module '" << name << "'' was not found in the cache";
+            ES_WARNING(warning);
+            return(false);
+        }
+        p_module->GetAttribute("autoload",enabled);
+        return(enabled);
+    }
+
     CXMLElement* p_module = GetModule(name);
     if( p_module == NULL ){
         CSmallString warning;
@@ -1226,7 +1749,6 @@ bool CModCache::IsAutoloadEnabled(const CSmallString& name)
         return(false);
     }
 
-    bool enabled = true;
     p_module->GetAttribute("autoload",enabled);
     return(enabled);
 }
@@ -1248,7 +1770,14 @@ double CModCache::GetNewVerIndex(const CSmallString& build)
         return(verindex);
     }
 
-    CXMLElement* p_sele = p_module->GetChildElementByPath("builds/build");
+    // version index contains only unique versions
+    const char*  p_name = "version";
+    CXMLElement* p_sele = p_module->GetChildElementByPath("versions/version");
+    if( p_sele == NULL ){
+        // old cache
+        p_name = "build";
+        p_sele = p_module->GetChildElementByPath("builds/build");
+    }
 
     while( p_sele != NULL ) {
         double lverindex = 0.0;
@@ -1263,7 +1792,7 @@ double CModCache::GetNewVerIndex(const CSmallString& build)
         if( lverindex > verindex ){
             verindex = lverindex;
         }
-        p_sele = p_sele->GetNextSiblingElement("build");
+        p_sele = p_sele->GetNextSiblingElement(p_name);
     }
 
     verindex++;
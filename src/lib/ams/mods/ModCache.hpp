@@ -29,7 +29,11 @@
 #include <FileName.hpp>
 #include <Terminal.hpp>
 #include <VerboseStr.hpp>
+#include <ROXMLDocument.hpp>
 #include <list>
+#include <vector>
+#include <map>
+#include <string.h>
 
 //------------------------------------------------------------------------------
 
@@ -45,6 +49,9 @@ public:
     /// save a single cache file
     bool SaveCacheFile(const CFileName& name);
 
+    /// load a single cache file in the read-only mode
+    bool LoadReadOnlyCacheFile(const CFileName& name);
+
 // executive methods -----------------------------------------------------------
     /// remove documentation elements
     void RemoveDocumentation(void);
@@ -55,6 +62,12 @@ public:
     // merge caches - p_origin is bundle config
     void MergeWithCache(CXMLElement* p_bcele,CXMLElement* p_origin=NULL);
 
+    // merge read-only cache - modules are materialized on demand
+    void MergeWithReadOnlyCache(const CROXMLElement* p_bcele,CXMLElement* p_origin=NULL);
+
+    // merge cache file - modules are parsed directly into the cache, present modules are skipped
+    bool MergeWithCacheFile(const CFileName& name,CXMLElement* p_origin=NULL);
+
     /// create empty cache and return pointer to <cache> element
     CXMLElement* CreateEmptyCache(void);
 
@@ -68,7 +81,17 @@ public:
     /// return cache element
     CXMLElement* GetCacheElement(void);
 
+    /// is the cache in the read-only mode?
+    /// the mode is set by LoadReadOnlyCacheFile and MergeWithReadOnlyCache
+    bool IsReadOnly(void) const;
+
+    /// return read-only cache element, NULL if not loaded
+    const CROXMLElement* GetReadOnlyCacheElement(void) const;
+
     /// get module element
+    /// this is the only place where read-only modules are copied into Cache,
+    /// i.e. module activation, PrintModuleVersions/Builds/Origin, GetNewVerIndex
+    /// and callers outside CModCache, listings work on the read-only data
     CXMLElement* GetModule(const CSmallString& name,bool create=false);
 
     /// create module element
@@ -101,6 +124,12 @@ public:
     static void GetModuleBuildsSorted(CXMLElement* p_mele, const CSmallString& vers,
                                       std::list<CSmallString>& list, bool includename=false);
 
+    /// sort module builds and create version index
+    static void SortModuleBuilds(CXMLElement* p_mele);
+
+    /// precompute categories, versions, and print widths for avail listing
+    static void UpdateModuleAvail(CXMLElement* p_mele);
+
     /// check if module can be exported - default true
     static bool CanModuleBeExported(CXMLElement* p_mele);
 
@@ -190,6 +219,43 @@ public:
 // section of protected data ---------------------------------------------------
 protected:
     CXMLDocument    Cache;
+
+    // read-only mode - modules are copied into Cache only when they are requested
+    struct SROModule {
+        const CROXMLElement*    Module;
+        CXMLElement*            Origin;         // bundle config
+        CXMLElement*            Materialized;   // copy in Cache or NULL
+    };
+
+    struct SROModuleNameLess {
+        bool operator()(const char* p_left,const char* p_right) const {
+            return( strcmp(p_left,p_right) < 0 );
+        }
+    };
+
+    typedef std::map<const char*,size_t,SROModuleNameLess> TROModuleIndex;
+
+    bool                    ReadOnly;
+    CROXMLDocument          ROCache;
+    std::vector<SROModule>  ROModules;      // in the merge order
+    TROModuleIndex          ROModuleIndex;  // module name -> ROModules
+
+    /// add read-only module, the first module with a given name wins
+    void AddReadOnlyModule(const CROXMLElement* p_mele,CXMLElement* p_origin);
+
+    /// find read-only module, NULL if not found
+    const CROXMLElement* FindReadOnlyModule(const CSmallString& name) const;
+
+    /// copy read-only module into Cache
+    CXMLElement* MaterializeModule(SROModule& rec);
+
+    /// drop read-only data
+    void ClearReadOnlyData(void);
+
+    /// add build suggestion for cgen
+    static void AddBuildForCGen(std::list<CSmallString>& list,int numparts,
+                                const CSmallString& name,const CSmallString& ver,
+                                const CSmallString& arch,const CSmallString& mode);
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,296 @@
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <ModCacheReader.hpp>
+#include <ROXMLDocument.hpp>
+#include <XMLText.hpp>
+#include <ErrorSystem.hpp>
+#include <fstream>
+#include <string.h>
+#include <ctype.h>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CModCacheReader::CModCacheReader(void)
+{
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CModCacheReader::MergeCacheFile(const CFileName& name,CXMLElement* p_cele,CXMLElement* p_origin)
+{
+    if( p_cele == NULL ){
+        RUNTIME_ERROR("p_cele is NULL");
+    }
+
+    // modules from higher-priority bundles
+    Modules.clear();
+    CXMLElement* p_mele = p_cele->GetFirstChildElement("module");
+    while( p_mele != NULL ) {
+        CSmallString modname;
+        p_mele->GetAttribute("name",modname);
+        Modules.insert(string(modname));
+        p_mele = p_mele->GetNextSiblingElement("module");
+    }
+
+    if( ReadFile(name) == false ){
+        CSmallString error;
+        error << "unable to read module cache file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    bool result = Parse(p_cele,p_origin);
+
+    if( result == false ){
+        // do not keep incomplete modules without origin in the merged cache
+        for(CXMLElement* p_added : Added){
+            delete p_added;
+        }
+    }
+
+    Buffer.clear();
+    Modules.clear();
+    Added.clear();
+
+    if( result == false ){
+        CSmallString error;
+        error << "unable to parse module cache file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CModCacheReader::ReadFile(const CFileName& name)
+{
+    Buffer.clear();
+
+    ifstream ifs(name,ios::in | ios::binary);
+    if( ! ifs ) return(false);
+
+    ifs.seekg(0,ios::end);
+    streamoff size = ifs.tellg();
+    ifs.seekg(0,ios::beg);
+    if( size < 0 ) return(false);
+
+    Buffer.resize(size+1);
+    if( (size > 0) && (! ifs.read(&Buffer[0],size)) ) return(false);
+    Buffer[size] = '\0';
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CModCacheReader::Parse(CXMLElement* p_cele,CXMLElement* p_origin)
+{
+    // open elements - names point into Buffer, targets are NULL for skipped subtrees
+    std::vector<const char*>    names;
+    std::vector<CXMLElement*>   targets;
+    std::vector< std::pair<const char*,const char*> > attrs;
+
+    Added.clear();
+
+    char* p = &Buffer[0];
+
+    for(;;){
+        char* p_text = p;
+        p = strchr(p,'<');
+        if( p == NULL ) break;
+
+        // text of materialized elements
+        if( (targets.empty() == false) && (targets.back() != NULL) && (p > p_text) ){
+            if( AddText(targets.back(),p_text,p) == false ) return(false);
+        }
+
+        // declarations, comments, and CDATA sections
+        if( strncmp(p,"<?",2) == 0 ){
+            p = strstr(p+2,"?>");
+            if( p == NULL ) return(false);
+            p += 2;
+            continue;
+        }
+        if( strncmp(p,"<!--",4) == 0 ){
+            p = strstr(p+4,"-->");
+            if( p == NULL ) return(false);
+            p += 3;
+            continue;
+        }
+        if( strncmp(p,"<![CDATA[",9) == 0 ){
+            char* p_data = p + 9;
+            p = strstr(p_data,"]]>");
+            if( p == NULL ) return(false);
+            if( (targets.empty() == false) && (targets.back() != NULL) ){
+                *p = '\0';
+                targets.back()->CreateChildText(CSmallString(p_data));
+            }
+            p += 3;
+            continue;
+        }
+        if( strncmp(p,"<!",2) == 0 ){
+            p = strchr(p+2,'>');
+            if( p == NULL ) return(false);
+            p++;
+            continue;
+        }
+
+        // end tag
+        if( p[1] == '/' ){
+            char* p_name = p + 2;
+            char* p_end = p_name;
+            while( (*p_end != '\0') && (*p_end != '>') && (isspace((unsigned char)*p_end) == 0) ) p_end++;
+            size_t len = p_end - p_name;
+            if( names.empty() ) return(false);
+            const char* p_open = names.back();
+            if( (strncmp(p_open,p_name,len) != 0) || (p_open[len] != '\0') ) return(false);
+            p = strchr(p_end,'>');
+            if( p == NULL ) return(false);
+            p++;
+            // module is complete
+            if( (names.size() == 2) && (targets.back() != NULL) && (p_origin != NULL) ){
+                p_origin->DuplicateNode(targets.back());
+            }
+            names.pop_back();
+            targets.pop_back();
+            continue;
+        }
+
+        // start tag
+        char* p_name = p + 1;
+        char* p_end = p_name;
+        while( (*p_end != '\0') && (*p_end != '/') && (*p_end != '>') && (isspace((unsigned char)*p_end) == 0) ) p_end++;
+        if( (p_end == p_name) || (*p_end == '\0') ) return(false);
+
+        // terminate name in place, c is the overwritten character
+        char c = *p_end;
+        *p_end = '\0';
+        p = p_end;
+
+        // attributes
+        attrs.clear();
+        bool empty = false;
+        for(;;){
+            while( isspace((unsigned char)c) != 0 ){
+                p++;
+                c = *p;
+            }
+            if( c == '>' ){
+                p++;
+                break;
+            }
+            if( c == '/' ){
+                if( p[1] != '>' ) return(false);
+                p += 2;
+                empty = true;
+                break;
+            }
+            if( c == '\0' ) return(false);
+
+            char* p_aname = p;
+            while( (*p != '\0') && (*p != '=') && (isspace((unsigned char)*p) == 0) ) p++;
+            char* p_aname_end = p;
+            while( isspace((unsigned char)*p) != 0 ) p++;
+            if( *p != '=' ) return(false);
+            p++;
+            *p_aname_end = '\0';
+
+            while( isspace((unsigned char)*p) != 0 ) p++;
+            char quote = *p;
+            if( (quote != '"') && (quote != '\'') ) return(false);
+            char* p_value = ++p;
+            p = strchr(p,quote);
+            if( p == NULL ) return(false);
+            *p = '\0';
+            p++;
+            if( CROXMLDocument::DecodeEntities(p_value) == false ) return(false);
+
+            attrs.push_back(std::make_pair((const char*)p_aname,(const char*)p_value));
+            c = *p;
+        }
+
+        // decide where the element goes
+        CXMLElement* p_target = NULL;
+        if( names.empty() ){
+            // root element
+            if( strcmp(p_name,"cache") != 0 ) return(false);
+        } else if( names.size() == 1 ){
+            // only new modules are merged
+            if( strcmp(p_name,"module") == 0 ){
+                const char* p_modname = "";
+                for(const auto& attr : attrs){
+                    if( strcmp(attr.first,"name") == 0 ) p_modname = attr.second;
+                }
+                if( Modules.insert(p_modname).second == true ){
+                    p_target = p_cele->CreateChildElement(p_name);
+                    Added.push_back(p_target);
+                }
+            }
+        } else if( targets.back() != NULL ){
+            p_target = targets.back()->CreateChildElement(p_name);
+        }
+
+        if( p_target != NULL ){
+            for(const auto& attr : attrs){
+                p_target->SetAttribute(attr.first,CSmallString(attr.second));
+            }
+        }
+
+        if( empty ){
+            if( (names.size() == 1) && (p_target != NULL) && (p_origin != NULL) ){
+                p_origin->DuplicateNode(p_target);
+            }
+        } else {
+            names.push_back(p_name);
+            targets.push_back(p_target);
+        }
+    }
+
+    return( names.empty() );
+}
+
+//------------------------------------------------------------------------------
+
+bool CModCacheReader::AddText(CXMLElement* p_ele,char* p_text,char* p_end)
+{
+    // the text is decoded in place, '<' at p_end is restored
+    char c = *p_end;
+    *p_end = '\0';
+    bool result = CROXMLDocument::DecodeEntities(p_text);
+    if( result ) p_ele->CreateChildText(CSmallString(p_text));
+    *p_end = c;
+    return(result);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
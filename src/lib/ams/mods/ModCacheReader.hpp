@@ -0,0 +1,67 @@
+#ifndef ModCacheReaderH
+#define ModCacheReaderH
+// =============================================================================
+//  AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <FileName.hpp>
+#include <XMLElement.hpp>
+#include <vector>
+#include <set>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+/// streaming reader of bundle cache files - the file is scanned once and
+/// modules are created directly in the merged cache element, modules that are
+/// already present in the merged cache are skipped without creating any nodes
+/// texts (including white characters) and CDATA sections are kept, comments
+/// and declarations are skipped
+
+class AMS_PACKAGE CModCacheReader {
+public:
+// constructor -----------------------------------------------------------------
+    CModCacheReader(void);
+
+// executive methods -----------------------------------------------------------
+    /// merge modules from the cache file into the cache element p_cele,
+    /// p_origin is copied into each added module
+    bool MergeCacheFile(const CFileName& name,CXMLElement* p_cele,CXMLElement* p_origin);
+
+// section of private data -----------------------------------------------------
+private:
+    std::vector<char>           Buffer;     // file content, modified by parser
+    std::set<std::string>       Modules;    // modules present in the merged cache
+    std::vector<CXMLElement*>   Added;      // modules added by Parse
+
+    /// read the whole file into Buffer
+    bool ReadFile(const CFileName& name);
+
+    /// parse Buffer and merge modules, added modules are removed on failure
+    bool Parse(CXMLElement* p_cele,CXMLElement* p_origin);
+
+    /// add text to the element
+    static bool AddText(CXMLElement* p_ele,char* p_text,char* p_end);
+};
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -36,9 +36,11 @@
 #include <map>
 #include <list>
 #include <AddDatagramSender.hpp>
+#include <ActivationCache.hpp>
 #include <SiteController.hpp>
 #include <User.hpp>
 #include <fnmatch.h>
+#include <AMSProfiler.hpp>
 
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -102,6 +104,8 @@ void CModule::SetModuleExportFlag(bool set)
 
 EModuleError CModule::AddModule(CVerboseStr& vout,CSmallString module,bool fordep,bool do_not_export)
 {
+    CAMSProfilerPhase phase("module-add");
+
     // determine print level -----------------------
     EModulePrintLevel print_level =  GlobalPrintLevel;
     if( (Level > 0) && (GlobalPrintLevel != EAPL_NONE) ) print_level = EAPL_SHORT;
@@ -272,6 +276,8 @@ EModuleError CModule::AddModule(CVerboseStr& vout,CSmallString module,bool forde
 
 EModuleError CModule::RemoveModule(CVerboseStr& vout,CSmallString module)
 {
+    CAMSProfilerPhase phase("module-remove");
+
     module.GetSubstitute('/',':');
 
     // determine print level -----------------------
@@ -478,6 +484,12 @@ void CModule::AddAllOrigins(CVerboseStr& vout, const CSmallString module, std::l
     CSmallString build_name;
     build_name << name << ":" << ver << ":" << arch << ":" << mode;
 
+    // builds shared by several requested modules are resolved only once
+    if( OriginBuilds.insert(std::string(build_name)).second == false ){
+        vout << "# Build already processed : " << build_name << endl;
+        return;
+    }
+
     // solve module dependencies -------------------
     CXMLElement* p_build = CModCache::GetBuild(p_mele,ver,arch,mode);
     if( p_build == NULL ) {
@@ -665,24 +677,21 @@ bool CModule::PrepareModuleEnvironment(CXMLElement* p_build,
         return(false);
     }
 
-    // now update AMS_ACTIVE_MODULES and AMS_EXPORTED_MODULES variables
+    // now update lists of active and exported modules
+    // AMS_ACTIVE_MODULES and AMS_EXPORTED_MODULES are deferred until the next script or exec action
 
     switch(action){
         case(EMA_ADD_MODULE):
-        ShellProcessor.AppendValueToVariable("AMS_ACTIVE_MODULES",complete_module,"|");
         ModuleController.UpdateActiveModules(complete_module,EMA_ADD_MODULE);
 
         if( (ModuleExportFlag == true) && (exported_module != NULL) ) {
-            ShellProcessor.AppendValueToVariable("AMS_EXPORTED_MODULES",exported_module,"|");
             ModuleController.UpdateExportedModules(exported_module,EMA_ADD_MODULE);
         }
         break;
     case(EMA_REMOVE_MODULE):
-        ShellProcessor.RemoveValueFromVariable("AMS_ACTIVE_MODULES",complete_module,"|");
         ModuleController.UpdateActiveModules(complete_module,EMA_REMOVE_MODULE);
 
         if( exported_module != NULL ) {
-            ShellProcessor.RemoveValueFromVariable("AMS_EXPORTED_MODULES",exported_module,"|");
             ModuleController.UpdateExportedModules(exported_module,EMA_REMOVE_MODULE);
         }
         break;
@@ -934,17 +943,11 @@ bool CModule::DetermineArchAuto(CVerboseStr& vout,
                                         const CSmallString& ver,
                                         CSmallString& arch)
 {
-    CSmallString sys_arch = Host.GetArchTokens();
-
     if( GlobalPrintLevel == EAPL_VERBOSE ) {
         vout << " INFO:" << endl;
         vout << " INFO: Testing architectures ..." << endl;
     }
 
-    list<string> sys_tokens;
-    string       ssys_arch(sys_arch);
-    split(sys_tokens,ssys_arch,is_any_of(","));
-
     int best_match = 0;
     int best_score = -1;
     CSmallString found_arch;
@@ -984,19 +987,9 @@ bool CModule::DetermineArchAuto(CVerboseStr& vout,
 
             while( bit != bet ){
 
-                bool found = false;
-                list<string>::iterator sit = sys_tokens.begin();
-                list<string>::iterator set = sys_tokens.end();
-
-                while( sit != set ){
-                    if( (*bit) == (*sit) ){
-                        score += HostGroup.GetArchTokenScore(*sit);
-                        found = true;
-                        break;
-                    }
-                    sit++;
-                }
-                if( found ){
+                CSmallString token(bit->c_str());
+                if( Host.HasToken(token) ){
+                    score += HostGroup.GetArchTokenScore(token);
                     matches++;
                 } else {
                     failures++;
@@ -1666,7 +1659,12 @@ bool CModule::AddHelp(const CSmallString& mod_name)
         p_ele->CreateChildText(svers);
     }
 
+    // the documentation is not part of the small cache, load only this module one
+    CXMLDocument doc;
     CXMLElement* p_doc = CModCache::GetModuleDoc(p_module);
+    if( (p_doc == NULL) && CModBundle::LoadModuleDoc(p_module,doc) ){
+        p_doc = doc.GetFirstChildElement("doc");
+    }
     if(  p_doc != NULL  ){
         // create title
         p_ele = p_mele->CreateChildElement("h2");
@@ -1781,6 +1779,23 @@ const CSmallString CModule::GetErrorStr(EModuleError error)
 //==============================================================================
 
 void CModule::EmitAddAction(const CSmallString& build_name)
+{
+    CSmallString name = CModUtils::GetModuleName(build_name);
+
+    CXMLElement* p_module = ModCache.GetModule(name);
+    if( p_module == NULL ) return;
+
+    CSmallString bundle_name = CModCache::GetBundleName(p_module);
+
+    // record for the activation cache
+    ActivationCache.AddBuild(build_name,bundle_name);
+
+    EmitAddAction(build_name,bundle_name);
+}
+
+//------------------------------------------------------------------------------
+
+void CModule::EmitAddAction(const CSmallString& build_name,const CSmallString& bundle_name)
 {
     CAddDatagramSender ads;
 
@@ -1797,10 +1812,7 @@ void CModule::EmitAddAction(const CSmallString& build_name)
     ads.Datagram.SetModuleArch(arch);
     ads.Datagram.SetModuleMode(mode);
 
-    CXMLElement* p_module = ModCache.GetModule(name);
-    if( p_module == NULL ) return;
-
-    ads.Datagram.SetBundleName(CModCache::GetBundleName(p_module));
+    ads.Datagram.SetBundleName(bundle_name);
 
     ads.Datagram.SetNCPUs(Host.GetNCPUs());
     ads.Datagram.SetNumOfHostCPUs(Host.GetNumOfHostCPUs());
@@ -30,6 +30,8 @@
 #include <VerboseStr.hpp>
 #include <ShellProcessor.hpp>
 #include <list>
+#include <set>
+#include <string>
 
 //------------------------------------------------------------------------------
 
@@ -97,6 +99,9 @@ public:
     /// print module origins
     void AddAllOrigins(CVerboseStr& vout, const CSmallString module, std::list<CFileName>& list, bool fordep=false);
 
+    /// emit add action for the build from the given bundle (activation cache replay)
+    void EmitAddAction(const CSmallString& build_name,const CSmallString& bundle_name);
+
     /// set print level
     void SetPrintLevel(EModulePrintLevel set);
 
@@ -138,6 +143,7 @@ private:
     bool                        ModuleExportFlag;
     int                         ModuleFlags;        // module flags used for statistics
     std::list<CSmallString>     DepList;            // dependency list - to avoid dependency cycles
+    std::set<std::string>       OriginBuilds;       // builds already processed by AddAllOrigins
 
     CXMLDocument                HTMLHelp;
 
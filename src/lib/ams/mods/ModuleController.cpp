@@ -29,6 +29,12 @@
 #include <Utils.hpp>
 #include <PrintEngine.hpp>
 #include <Module.hpp>
+#include <AMSProfiler.hpp>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <system_error>
 
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -55,11 +61,8 @@ void CModuleController::InitModuleControllerConfig(void)
     BundlePath  = AMSRegistry.GetBundlePath();
 
 // these are runtime informations
-    std::string sActiveModules   = std::string(CShell::GetSystemVariable("AMS_ACTIVE_MODULES"));
-    if( ! sActiveModules.empty() ) split(ActiveModules,sActiveModules,is_any_of("|"),boost::token_compress_on);
-
-    std::string sExportedModules = std::string(CShell::GetSystemVariable("AMS_EXPORTED_MODULES"));
-    if( ! sExportedModules.empty() ) split(ExportedModules,sExportedModules,is_any_of("|"),boost::token_compress_on);
+    ActiveModules.Parse(CShell::GetSystemVariable("AMS_ACTIVE_MODULES"));
+    ExportedModules.Parse(CShell::GetSystemVariable("AMS_EXPORTED_MODULES"));
 }
 
 //------------------------------------------------------------------------------
@@ -76,6 +79,8 @@ void CModuleController::InitModuleControllerConfig(const CSmallString& bundle_na
 
 void CModuleController::LoadBundles(EModBundleCache type)
 {
+    CAMSProfilerPhase phase("bundles-load");
+
     Bundles.clear();
 
     std::list<CFileName>    names;
@@ -87,7 +92,46 @@ void CModuleController::LoadBundles(EModBundleCache type)
     split(names,sname,is_any_of(","));
     split(paths,spath,is_any_of(":"));
 
-    for(CFileName name : names){
+    // discover bundles and prefetch their files concurrently by a small pool of workers
+    // open latency on network filesystems would otherwise add up for each bundle
+    // the XML parsers and the error system are not thread-safe, the bundles are
+    // thus parsed afterwards in the order of names
+    std::vector<CFileName>  vnames(names.begin(),names.end());
+    std::vector<char>       found(vnames.size(),0);    // not vector<bool> - it is packed
+    std::atomic<size_t>     next(0);
+
+    auto prefetch = [&paths,&vnames,&found,&next,type](void){
+        for(size_t i = next++; i < vnames.size(); i = next++){
+            for(const CFileName& path : paths){
+                if( CModBundle::PrefetchBundle(path,vnames[i],type) == false ) continue;
+                found[i] = 1;
+                break;
+            }
+        }
+    };
+
+    size_t nworkers = std::thread::hardware_concurrency();
+    if( nworkers == 0 ) nworkers = 1;
+    if( nworkers > vnames.size() ) nworkers = vnames.size();
+
+    // the calling thread is also a worker, it prefetches remaining bundles
+    // if no thread can be started
+    std::vector<std::thread> tasks;
+    for(size_t i=1; i < nworkers; i++){
+        try {
+            tasks.push_back(std::thread(prefetch));
+        } catch(std::system_error&) {
+            break;
+        }
+    }
+    prefetch();
+    for(std::thread& task : tasks){
+        task.join();
+    }
+
+    for(size_t i=0; i < vnames.size(); i++){
+        if( found[i] == 0 ) continue;
+        CFileName name = vnames[i];
         for(CFileName path : paths){
             if( CModBundle::IsBundle(path,name) == false ) continue;
             CModBundlePtr p_bundle(new CModBundle());
@@ -98,7 +142,15 @@ void CModuleController::LoadBundles(EModBundleCache type)
                 ES_WARNING(warning);
                 continue;
             }
-            if( p_bundle->LoadCache(type) == false ){
+            // the small cache is never modified - use the read-only mode
+            // the big cache is streamed directly into the merged cache
+            bool loaded;
+            if( type == EMBC_BIG ){
+                loaded = p_bundle->DeferCache(type);
+            } else {
+                loaded = p_bundle->LoadCache(type,type == EMBC_SMALL);
+            }
+            if( loaded == false ){
                 // this is fishy - record
                 CSmallString warning;
                 warning << "unable to load cache for bundle '" << path / name << "'";
@@ -140,58 +192,69 @@ void CModuleController::MergeBundles(void)
 
 void CModuleController::MergeBundles(CModCache& mod_cache)
 {
+    CAMSProfilerPhase phase("bundles-merge");
+
     mod_cache.CreateEmptyCache();
 
     for( CModBundlePtr p_bundle : Bundles ){
-        CXMLElement* p_cache = p_bundle->GetCacheElement();
         CXMLElement* p_config = p_bundle->GetBundleElement();
-        mod_cache.MergeWithCache(p_cache,p_config);
+        if( p_bundle->IsCacheDeferred() ){
+            CFileName cache_file = p_bundle->GetCacheFileName();
+            if( mod_cache.MergeWithCacheFile(cache_file,p_config) == false ){
+                CSmallString warning;
+                warning << "unable to merge cache of bundle '" << p_bundle->GetFullBundleName() << "'";
+                ES_WARNING(warning);
+            }
+        } else if( p_bundle->IsReadOnly() ){
+            mod_cache.MergeWithReadOnlyCache(p_bundle->GetReadOnlyCacheElement(),p_config);
+        } else {
+            CXMLElement* p_cache = p_bundle->GetCacheElement();
+            mod_cache.MergeWithCache(p_cache,p_config);
+        }
     }
 }
 
-//==============================================================================
 //------------------------------------------------------------------------------
-//==============================================================================
 
-bool CModuleController::IsModuleActive(const CSmallString& module)
+const CSmallString CModuleController::GetBundlesSignature(void)
 {
-    CSmallString name,ver,arch,para;
-    CModUtils::ParseModuleName(module,name,ver,arch,para);
-
-    for(CSmallString mactive : ActiveModules){
-        CSmallString lname,lver,larch,lpara;
-        CModUtils::ParseModuleName(mactive,lname,lver,larch,lpara);
-        if( lname == name ) {
-            if( ver == NULL ) return(true);
-            if( lver == ver ) {
-                if( arch == NULL ) return(true);
-                if( larch == arch ) {
-                    if( para == NULL ) return(true);
-                    if( lpara == para ) return(true);
-                }
-            }
+    std::list<CFileName>    names;
+    std::list<CFileName>    paths;
+
+    std::string sname(BundleName);
+    std::string spath(BundlePath);
+
+    split(names,sname,is_any_of(","));
+    split(paths,spath,is_any_of(":"));
+
+    // the same bundles as in LoadBundles
+    std::stringstream signature;
+    for(CFileName name : names){
+        for(CFileName path : paths){
+            if( CModBundle::IsBundle(path,name) == false ) continue;
+            signature << (const char*)CModBundle::GetCacheSignature(path,name);
+            signature << ";";
+            break;
         }
     }
 
-    return(false);
+    return(signature.str().c_str());
 }
 
+//==============================================================================
 //------------------------------------------------------------------------------
+//==============================================================================
 
-bool CModuleController::IsModuleExported(const CSmallString& module)
+bool CModuleController::IsModuleActive(const CSmallString& module)
 {
-    CSmallString name,ver,arch,para;
-    CModUtils::ParseModuleName(module,name,ver,arch,para);
-
-    for(CSmallString mexported : ExportedModules){
-        CSmallString lname,lver,larch,lpara;
-        CModUtils::ParseModuleName(mexported,lname,lver,larch,lpara);
-        if( lname == name ) {
-            return(true);
-        }
-    }
+    return( ActiveModules.Find(module) != NULL );
+}
 
-    return(false);
+//------------------------------------------------------------------------------
+
+bool CModuleController::IsModuleExported(const CSmallString& module)
+{
+    return( ExportedModules.FindByName(CModUtils::GetModuleName(module)) != NULL );
 }
 
 //==============================================================================
@@ -203,85 +266,43 @@ bool CModuleController::GetActiveModuleVersion(const CSmallString& module,
 {
     actver = NULL;
 
-    CSmallString name,ver,arch,para;
-    CModUtils::ParseModuleName(module,name,ver,arch,para);
+    const CActiveModule* p_rec = ActiveModules.Find(module);
+    if( p_rec == NULL ) return(false);
 
-    for(CSmallString mactive : ActiveModules){
-        CSmallString lname,lver,larch,lpara;
-        CModUtils::ParseModuleName(mactive,lname,lver,larch,lpara);
-        if( lname == name ) {
-            if( ver == NULL ) {
-                actver = lver;
-                return(true);
-            }
-            if( lver == ver ) {
-                if( arch == NULL ) {
-                    actver = lver;
-                    return(true);
-                }
-                if( larch == arch ) {
-                    if( para == NULL ) {
-                        actver = lver;
-                        return(true);
-                    }
-                    if( lpara == para ) {
-                        actver = lver;
-                        return(true);
-                    }
-                }
-            }
-        }
-    }
-
-    return(false);
+    actver = p_rec->Ver;
+    return(true);
 }
 
 //------------------------------------------------------------------------------
 
 const CSmallString CModuleController::GetActiveModules(void)
 {
-    CSmallString    amods;
-    bool            first = true;
-    for(CSmallString mod : ActiveModules){
-        if( ! first ) amods << "|";
-        amods << mod;
-        first = false;
-    }
-    return(amods);
+    return( ActiveModules.Serialize() );
 }
 
 //------------------------------------------------------------------------------
 
 const CSmallString CModuleController::GetExportedModules(void)
 {
-    CSmallString    emods;
-    bool            first = true;
-    for(CSmallString mod : ExportedModules){
-        if( ! first ) emods << "|";
-        emods << mod;
-        first = false;
-    }
-    return(emods);
+    return( ExportedModules.Serialize() );
 }
 
 //------------------------------------------------------------------------------
 
 const CSmallString CModuleController::GetActiveModuleSpecification(const CSmallString& name)
 {
-    for(CSmallString mactive : ActiveModules){
-        if( CModUtils::GetModuleName(mactive) == name ) return(mactive);
-    }
-    return("");
+    const CActiveModule* p_rec = ActiveModules.FindByName(name);
+    if( p_rec == NULL ) return("");
+    return(p_rec->Spec);
 }
 
 //------------------------------------------------------------------------------
 
 const CSmallString CModuleController::GetExportedModuleSpecification(const CSmallString& name)
 {
-    for(CSmallString mexported : ExportedModules){
-        if( CModUtils::GetModuleName(mexported) == name ) return(mexported);
-    }
-    return("");
+    const CActiveModule* p_rec = ExportedModules.FindByName(name);
+    if( p_rec == NULL ) return("");
+    return(p_rec->Spec);
 }
 
 //-----------------------------------------------------------------------------
@@ -289,8 +310,10 @@ const CSmallString CModuleController::GetExportedModuleSpecification(const CSmal
 void CModuleController::UpdateActiveModules(const CSmallString& module,
                                             EModuleAction action)
 {
-    ActiveModules.remove(module);
-    if( action == EMA_ADD_MODULE ) ActiveModules.push_back(module);
+    ActiveModules.Update(module,action);
+    if( ActiveModules.IsChanged() ){
+        ShellProcessor.SetDeferredVariable("AMS_ACTIVE_MODULES",ActiveModules.Serialize());
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -298,8 +321,10 @@ void CModuleController::UpdateActiveModules(const CSmallString& module,
 void CModuleController::UpdateExportedModules(const CSmallString& module,
                                               EModuleAction action)
 {
-    ExportedModules.remove(module);
-    if( action == EMA_ADD_MODULE ) ExportedModules.push_back(module);
+    ExportedModules.Update(module,action);
+    if( ExportedModules.IsChanged() ){
+        ShellProcessor.SetDeferredVariable("AMS_EXPORTED_MODULES",ExportedModules.Serialize());
+    }
 }
 
 //==============================================================================
@@ -310,21 +335,19 @@ void CModuleController::PrintActiveModules(CTerminal& terminal)
 {
     PrintEngine.PrintHeader(terminal,"ACTIVE MODULES",EPEHS_SECTION);
 
-    int maxmodlen = 0;
-    for(CSmallString mactive : ActiveModules){
-        int len = mactive.GetLength();
-        if( len > maxmodlen ) maxmodlen = len;
-    }
+    int maxmodlen = ActiveModules.GetMaxSpecLength();
     // do not count exported modules - their names are always shorter
     maxmodlen++;
 
     terminal.Printf("\n");
-    if( ActiveModules.size() == 0 ){
+    if( ActiveModules.GetNumberOfModules() == 0 ){
         std::list<CSmallString> none;
         none.push_back("-none-");
         PrintEngine.PrintItems(terminal,none,maxmodlen);
     } else {
-        PrintEngine.PrintItems(terminal,ActiveModules,maxmodlen);
+        std::list<CSmallString> amods;
+        ActiveModules.GetSpecifications(amods);
+        PrintEngine.PrintItems(terminal,amods,maxmodlen);
     }
 }
 
@@ -334,21 +357,19 @@ void CModuleController::PrintExportedModules(CTerminal& terminal)
 {
     PrintEngine.PrintHeader(terminal,"EXPORTED MODULES",EPEHS_SECTION);
 
-    int maxmodlen = 0;
-    for(CSmallString mactive : ActiveModules){
-        int len = mactive.GetLength();
-        if( len > maxmodlen ) maxmodlen = len;
-    }
+    int maxmodlen = ActiveModules.GetMaxSpecLength();
     // do not count exported modules - their names are always shorter
     maxmodlen++;
 
     terminal.Printf("\n");
-    if( ExportedModules.size() == 0 ){
+    if( ExportedModules.GetNumberOfModules() == 0 ){
         std::list<CSmallString> none;
         none.push_back("-none-");
         PrintEngine.PrintItems(terminal,none,maxmodlen);
     } else {
-        PrintEngine.PrintItems(terminal,ExportedModules,maxmodlen);
+        std::list<CSmallString> emods;
+        ExportedModules.GetSpecifications(emods);
+        PrintEngine.PrintItems(terminal,emods,maxmodlen);
     }
 }
 
@@ -378,7 +399,8 @@ void CModuleController::PrintUserAutoLoadedModules(CTerminal& terminal)
 
 bool CModuleController::ReactivateModules(CVerboseStr& vout)
 {
-    std::list<CSmallString> modules = ActiveModules;
+    std::list<CSmallString> modules;
+    ActiveModules.GetSpecifications(modules);
 
     bool result = true;
     for(CSmallString mod : modules){
@@ -396,7 +418,8 @@ bool CModuleController::ReactivateModules(CVerboseStr& vout)
 
 bool CModuleController::PurgeModules(CVerboseStr& vout)
 {
-    std::list<CSmallString> modules = ActiveModules;
+    std::list<CSmallString> modules;
+    ActiveModules.GetSpecifications(modules);
     modules.reverse();
 
     bool result = true;
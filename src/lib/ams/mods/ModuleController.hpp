@@ -27,6 +27,7 @@
 #include <FileName.hpp>
 #include <ModBundle.hpp>
 #include <ShellProcessor.hpp>
+#include <ActiveModules.hpp>
 #include <list>
 
 //------------------------------------------------------------------------------
@@ -53,6 +54,9 @@ public:
      /// merge them into a single cache
     void MergeBundles(CModCache& mod_cache);
 
+    /// get signature of bundle caches (path, mtime, and size) without loading them
+    const CSmallString GetBundlesSignature(void);
+
 // information about modules ---------------------------------------------------
     /// check if module is active
     bool IsModuleActive(const CSmallString& module);
@@ -87,9 +91,11 @@ public:
 
 // update module info ----------------------------------------------------------
     /// update list of active modules
+    /// AMS_ACTIVE_MODULES is written before the next script or exec action
     void UpdateActiveModules(const CSmallString& module,EModuleAction action);
 
     /// update list of exported modules
+    /// AMS_EXPORTED_MODULES is written before the next script or exec action
     void UpdateExportedModules(const CSmallString& module,EModuleAction action);
 
 // execution methods -----------------------------------------------------------
@@ -101,8 +107,8 @@ public:
 
 // section of private data -----------------------------------------------------
 private:
-    std::list<CSmallString>     ActiveModules;      // list of active modules
-    std::list<CSmallString>     ExportedModules;    // list of exported modules
+    CActiveModules              ActiveModules;      // list of active modules
+    CActiveModules              ExportedModules;    // list of exported modules
 
     CFileName                   BundleName;
     CFileName                   BundlePath;
@@ -61,24 +61,7 @@ void CAddStatDatagram::Finish(void)
     memcpy(Magic,"AMS9",4);
 
     // controll sum
-    int control_sum = 0;
-    for(unsigned int i=0; i < sizeof(Magic); i++) control_sum += Magic[i];
-    for(unsigned int i=0; i < sizeof(Site); i++) control_sum += Site[i];
-    for(unsigned int i=0; i < sizeof(ModuleName); i++) control_sum += ModuleName[i];
-    for(unsigned int i=0; i < sizeof(ModuleVers); i++) control_sum += ModuleVers[i];
-    for(unsigned int i=0; i < sizeof(ModuleArch); i++) control_sum += ModuleArch[i];
-    for(unsigned int i=0; i < sizeof(ModuleMode); i++) control_sum += ModuleMode[i];
-    for(unsigned int i=0; i < sizeof(BundleName); i++) control_sum += BundleName[i];
-    for(unsigned int i=0; i < sizeof(User); i++) control_sum += User[i];
-    for(unsigned int i=0; i < sizeof(HostName); i++) control_sum += HostName[i];
-    for(unsigned int i=0; i < sizeof(HostGroup); i++) control_sum += HostGroup[i];
-    for(unsigned int i=0; i < sizeof(NCPUs); i++) control_sum += NCPUs[i];
-    for(unsigned int i=0; i < sizeof(NumOfHostCPUs); i++) control_sum += NumOfHostCPUs[i];
-    for(unsigned int i=0; i < sizeof(NGPUs); i++) control_sum += NGPUs[i];
-    for(unsigned int i=0; i < sizeof(NumOfHostGPUs); i++) control_sum += NumOfHostGPUs[i];
-    for(unsigned int i=0; i < sizeof(NumOfNodes); i++) control_sum += NumOfNodes[i];
-    for(unsigned int i=0; i < sizeof(Flags); i++) control_sum += Flags[i];
-    for(unsigned int i=0; i < sizeof(Time); i++) control_sum += Time[i];
+    int control_sum = GetControlSum();
 
     Control[0] = (unsigned char) ((control_sum >> 24) & 0xFF);
     Control[1] = (unsigned char) ((control_sum >> 16) & 0xFF);
@@ -214,8 +197,13 @@ void CAddStatDatagram::SetFlags(int flags)
 
 void CAddStatDatagram::SetTimeAndDate(const CSmallTimeAndDate& dt)
 {
-    int seconds = dt.GetSecondsFromBeginning();
+    SetTime(dt.GetSecondsFromBeginning());
+}
 
+//------------------------------------------------------------------------------
+
+void CAddStatDatagram::SetTime(int seconds)
+{
     Time[0] = (unsigned char) ((seconds >> 24) & 0xFF);
     Time[1] = (unsigned char) ((seconds >> 16) & 0xFF);
     Time[2] = (unsigned char) ((seconds >>  8) & 0xFF);
@@ -234,6 +222,51 @@ bool CAddStatDatagram::IsValid(void)
     }
 
     // controll sum
+    int control_sum = GetControlSum();
+
+    int rec_control_sum;
+    rec_control_sum = (Control[0] << 24) + (Control[1] << 16)
+                      + (Control[2] << 8) + Control[3];
+
+    if( rec_control_sum != control_sum ) {
+        CSmallString error;
+        error << "sum: " << CSmallString(rec_control_sum) << " rec: " << CSmallString(control_sum);
+        ES_ERROR(error);
+        return(false);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CAddStatDatagram::CheckIntegrity(void) const
+{
+    // the same as IsValid but without error reporting, it is safe in worker threads
+    if( strncmp(Magic,"AMS9",4) != 0 ) return(false);
+
+    // strings must be terminated
+    if( memchr(Site,0,sizeof(Site)) == NULL ) return(false);
+    if( memchr(ModuleName,0,sizeof(ModuleName)) == NULL ) return(false);
+    if( memchr(ModuleVers,0,sizeof(ModuleVers)) == NULL ) return(false);
+    if( memchr(ModuleArch,0,sizeof(ModuleArch)) == NULL ) return(false);
+    if( memchr(ModuleMode,0,sizeof(ModuleMode)) == NULL ) return(false);
+    if( memchr(BundleName,0,sizeof(BundleName)) == NULL ) return(false);
+    if( memchr(User,0,sizeof(User)) == NULL ) return(false);
+    if( memchr(HostName,0,sizeof(HostName)) == NULL ) return(false);
+    if( memchr(HostGroup,0,sizeof(HostGroup)) == NULL ) return(false);
+
+    int rec_control_sum;
+    rec_control_sum = (Control[0] << 24) + (Control[1] << 16)
+                      + (Control[2] << 8) + Control[3];
+
+    return(rec_control_sum == GetControlSum());
+}
+
+//------------------------------------------------------------------------------
+
+int CAddStatDatagram::GetControlSum(void) const
+{
     int control_sum = 0;
     for(unsigned int i=0; i < sizeof(Magic); i++) control_sum += Magic[i];
     for(unsigned int i=0; i < sizeof(Site); i++) control_sum += Site[i];
@@ -253,18 +286,7 @@ bool CAddStatDatagram::IsValid(void)
     for(unsigned int i=0; i < sizeof(Flags); i++) control_sum += Flags[i];
     for(unsigned int i=0; i < sizeof(Time); i++) control_sum += Time[i];
 
-    int rec_control_sum;
-    rec_control_sum = (Control[0] << 24) + (Control[1] << 16)
-                      + (Control[2] << 8) + Control[3];
-
-    if( rec_control_sum != control_sum ) {
-        CSmallString error;
-        error << "sum: " << CSmallString(rec_control_sum) << " rec: " << CSmallString(control_sum);
-        ES_ERROR(error);
-        return(false);
-    }
-
-    return(true);
+    return(control_sum);
 }
 
 //------------------------------------------------------------------------------
@@ -385,6 +407,13 @@ const CSmallTimeAndDate CAddStatDatagram::GetTimeAndDate(void) const
     return(dt);
 }
 
+//------------------------------------------------------------------------------
+
+int CAddStatDatagram::GetTime(void) const
+{
+    return( (Time[0] << 24) + (Time[1] << 16) + (Time[2] << 8) + Time[3] );
+}
+
 //==============================================================================
 //------------------------------------------------------------------------------
 //==============================================================================
@@ -52,9 +52,11 @@ struct CAddStatDatagram {
     void SetNumOfNodes(int nnodes);
     void SetFlags(int flags);
     void SetTimeAndDate(const CSmallTimeAndDate& dt);
+    void SetTime(int seconds);
 
     // get methods ----------------------------------------------------------------
     bool IsValid(void);
+    bool CheckIntegrity(void) const;
 
     const CSmallString      GetSite(void) const;
     const CSmallString      GetModuleName(void) const;
@@ -72,6 +74,7 @@ struct CAddStatDatagram {
     int                     GetNumOfNodes(void) const;
     int                     GetFlags(void) const;
     const CSmallTimeAndDate GetTimeAndDate(void) const;
+    int                     GetTime(void) const;
 
     // section of private data ----------------------------------------------------
 private:
@@ -93,6 +96,8 @@ private:
     unsigned char   NumOfNodes[4];          // number of nodes
     unsigned char   Flags[4];               // 32 bit flags
     unsigned char   Time[4];                // time in seconds from 00:00:00 UTC, January 1, 1970
+
+    int GetControlSum(void) const;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,281 @@
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+// =============================================================================
+
+#include <StatPacket.hpp>
+#include <SoftStat.hpp>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+
+#define STAT_PACKET_MAGIC       "AMSD"
+#define STAT_PACKET_HEADER_SIZE 12
+
+// the packet fits into the standard ethernet MTU
+#define STAT_PACKET_MAX_SIZE    1400
+#define STAT_PACKET_MAX_RECORDS 255
+#define STAT_PACKET_MAX_DICT    128
+#define STAT_PACKET_MAX_STRING  127
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CStatPacket::CStatPacket(void)
+{
+    Clear();
+}
+
+//------------------------------------------------------------------------------
+
+void CStatPacket::Clear(void)
+{
+    Data.assign(STAT_PACKET_HEADER_SIZE,'\0');
+    Dictionary.clear();
+    NumOfRecords = 0;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CStatPacket::AddRecord(const CAddStatDatagram& record)
+{
+    if( NumOfRecords >= STAT_PACKET_MAX_RECORDS ) return(false);
+
+    size_t old_size = Data.size();
+    size_t old_dict = Dictionary.size();
+
+    WriteString(Data,Dictionary,record.GetSite());
+    WriteString(Data,Dictionary,record.GetModuleName());
+    WriteString(Data,Dictionary,record.GetModuleVers());
+    WriteString(Data,Dictionary,record.GetModuleArch());
+    WriteString(Data,Dictionary,record.GetModuleMode());
+    WriteString(Data,Dictionary,record.GetBundleName());
+    WriteString(Data,Dictionary,record.GetUser());
+    WriteString(Data,Dictionary,record.GetHostName());
+    WriteString(Data,Dictionary,record.GetHostGroup());
+    WriteVarUInt(Data,record.GetNCPUs());
+    WriteVarUInt(Data,record.GetNumOfHostCPUs());
+    WriteVarUInt(Data,record.GetNGPUs());
+    WriteVarUInt(Data,record.GetNumOfHostGPUs());
+    WriteVarUInt(Data,record.GetNumOfNodes());
+    WriteVarUInt(Data,record.GetFlags());
+    WriteVarUInt(Data,record.GetTime());
+
+    if( (Data.size() > STAT_PACKET_MAX_SIZE) && (NumOfRecords > 0) ){
+        // does not fit - roll back
+        Data.resize(old_size);
+        Dictionary.resize(old_dict);
+        return(false);
+    }
+
+    NumOfRecords++;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+const std::string& CStatPacket::Finish(void)
+{
+    memcpy(&Data[0],STAT_PACKET_MAGIC,4);
+    Data[4] = (char)ESF_V2;
+    Data[5] = (char)NumOfRecords;
+    Data[6] = 0;
+    Data[7] = 0;
+
+    uint32_t crc = CRC32C(Data.data() + STAT_PACKET_HEADER_SIZE,Data.size() - STAT_PACKET_HEADER_SIZE);
+    Data[8]  = (char)((crc >> 24) & 0xFF);
+    Data[9]  = (char)((crc >> 16) & 0xFF);
+    Data[10] = (char)((crc >>  8) & 0xFF);
+    Data[11] = (char)((crc      ) & 0xFF);
+
+    return(Data);
+}
+
+//------------------------------------------------------------------------------
+
+int CStatPacket::GetNumOfRecords(void) const
+{
+    return(NumOfRecords);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CStatPacket::IsPacket(const void* p_data,size_t size)
+{
+    if( size < STAT_PACKET_HEADER_SIZE ) return(false);
+    const unsigned char* p_udata = (const unsigned char*)p_data;
+    return( (memcmp(p_udata,STAT_PACKET_MAGIC,4) == 0) && (p_udata[4] == ESF_V2) );
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatPacket::DecodePacket(const void* p_data,size_t size,std::vector<CAddStatDatagram>& records)
+{
+    records.clear();
+    if( IsPacket(p_data,size) == false ) return(false);
+
+    const unsigned char* p_udata = (const unsigned char*)p_data;
+    const unsigned char* p_end = p_udata + size;
+
+    int      nrecords = p_udata[5];
+    uint32_t crc = ((uint32_t)p_udata[8] << 24) | ((uint32_t)p_udata[9] << 16)
+                 | ((uint32_t)p_udata[10] << 8) | (uint32_t)p_udata[11];
+
+    p_udata += STAT_PACKET_HEADER_SIZE;
+    if( CRC32C(p_udata,p_end - p_udata) != crc ) return(false);
+
+    std::vector<std::string> dict;
+    dict.reserve(STAT_PACKET_MAX_DICT);
+    records.resize(nrecords);
+
+    for(int i=0; i < nrecords; i++){
+        std::string strs[9];
+        uint32_t    ints[7];
+        for(int j=0; j < 9; j++){
+            if( ReadString(p_udata,p_end,dict,strs[j]) == false ) return(false);
+        }
+        for(int j=0; j < 7; j++){
+            if( ReadVarUInt(p_udata,p_end,ints[j]) == false ) return(false);
+        }
+
+        CAddStatDatagram& record = records[i];
+        record.SetSite(strs[0].c_str());
+        record.SetModuleName(strs[1].c_str());
+        record.SetModuleVers(strs[2].c_str());
+        record.SetModuleArch(strs[3].c_str());
+        record.SetModuleMode(strs[4].c_str());
+        record.SetBundleName(strs[5].c_str());
+        record.SetUser(strs[6].c_str());
+        record.SetHostName(strs[7].c_str());
+        record.SetHostGroup(strs[8].c_str());
+        record.SetNCPUs(ints[0]);
+        record.SetNumOfHostCPUs(ints[1]);
+        record.SetNGPUs(ints[2]);
+        record.SetNumOfHostGPUs(ints[3]);
+        record.SetNumOfNodes(ints[4]);
+        record.SetFlags(ints[5]);
+        record.SetTime(ints[6]);
+        record.Finish();
+    }
+
+    // trailing data are not allowed
+    return(p_udata == p_end);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+uint32_t CStatPacket::CRC32C(const void* p_data,size_t size)
+{
+    static const std::vector<uint32_t> table = [](){
+        std::vector<uint32_t> tab(256);
+        for(uint32_t i=0; i < 256; i++){
+            uint32_t crc = i;
+            for(int j=0; j < 8; j++){
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : (crc >> 1);
+            }
+            tab[i] = crc;
+        }
+        return(tab);
+    }();
+
+    const unsigned char* p_udata = (const unsigned char*)p_data;
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i=0; i < size; i++){
+        crc = table[(crc ^ p_udata[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return(crc ^ 0xFFFFFFFF);
+}
+
+//------------------------------------------------------------------------------
+
+void CStatPacket::WriteString(std::string& out,std::vector<std::string>& dict,const char* p_str)
+{
+    std::string str(p_str != NULL ? p_str : "");
+    if( str.size() > STAT_PACKET_MAX_STRING ) str.resize(STAT_PACKET_MAX_STRING);
+
+    // user, host, site, and group repeat in all records of a command
+    for(size_t i=0; i < dict.size(); i++){
+        if( dict[i] == str ){
+            out.push_back((char)(0x80 | i));
+            return;
+        }
+    }
+
+    out.push_back((char)str.size());
+    out.append(str);
+    if( dict.size() < STAT_PACKET_MAX_DICT ) dict.push_back(str);
+}
+
+//------------------------------------------------------------------------------
+
+void CStatPacket::WriteVarUInt(std::string& out,uint32_t value)
+{
+    while( value >= 0x80 ){
+        out.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatPacket::ReadString(const unsigned char*& p_data,const unsigned char* p_end,
+                             std::vector<std::string>& dict,std::string& value)
+{
+    if( p_data >= p_end ) return(false);
+    unsigned int tag = *p_data++;
+
+    if( tag & 0x80 ){
+        tag &= 0x7F;
+        if( tag >= dict.size() ) return(false);
+        value = dict[tag];
+        return(true);
+    }
+
+    if( (size_t)(p_end - p_data) < tag ) return(false);
+    value.assign((const char*)p_data,tag);
+    p_data += tag;
+    if( dict.size() < STAT_PACKET_MAX_DICT ) dict.push_back(value);
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatPacket::ReadVarUInt(const unsigned char*& p_data,const unsigned char* p_end,uint32_t& value)
+{
+    value = 0;
+    for(int shift=0; shift < 35; shift += 7){
+        if( p_data >= p_end ) return(false);
+        unsigned char byte = *p_data++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if( (byte & 0x80) == 0 ) return(true);
+    }
+    return(false);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,93 @@
+#ifndef StatPacketH
+#define StatPacketH
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+class CAddStatDatagram;
+
+//------------------------------------------------------------------------------
+
+/// version of statistics wire formats
+enum EStatFormat {
+    ESF_V1  = 1,        // fixed CAddStatDatagram, one record per packet
+    ESF_V2  = 2         // CStatPacket, several compact records per packet
+};
+
+//------------------------------------------------------------------------------
+
+/// compact statistics packet (wire format v2)
+/// header: magic "AMSD", version (1 byte), number of records (1 byte),
+///         reserved (2 bytes), CRC32C of the rest of packet (4 bytes)
+/// record: nine strings and seven unsigned varints in the CAddStatDatagram order
+/// string: one byte N < 128 followed by N bytes, the string is added into
+///         the packet dictionary, or one byte 128+I referring dictionary item I
+
+class AMS_PACKAGE CStatPacket {
+public:
+// constructor -----------------------------------------------------------------
+    CStatPacket(void);
+
+// executive methods -----------------------------------------------------------
+    /// add record, returns false if the packet is full
+    bool AddRecord(const CAddStatDatagram& record);
+
+    /// finish packet and return its data
+    const std::string& Finish(void);
+
+    /// remove all records
+    void Clear(void);
+
+// information methods ---------------------------------------------------------
+    /// get number of records
+    int GetNumOfRecords(void) const;
+
+    /// is it v2 packet? only header is tested
+    static bool IsPacket(const void* p_data,size_t size);
+
+    /// decode packet, it does not use ErrorSystem thus it can be used in worker threads
+    static bool DecodePacket(const void* p_data,size_t size,std::vector<CAddStatDatagram>& records);
+
+    /// CRC32C (Castagnoli) checksum
+    static uint32_t CRC32C(const void* p_data,size_t size);
+
+// section of private data -----------------------------------------------------
+private:
+    std::string                 Data;
+    std::vector<std::string>    Dictionary;
+    int                         NumOfRecords;
+
+    static void WriteString(std::string& out,std::vector<std::string>& dict,const char* p_str);
+    static void WriteVarUInt(std::string& out,uint32_t value);
+    static bool ReadString(const unsigned char*& p_data,const unsigned char* p_end,
+                           std::vector<std::string>& dict,std::string& value);
+    static bool ReadVarUInt(const unsigned char*& p_data,const unsigned char* p_end,uint32_t& value);
+};
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,279 @@
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+// =============================================================================
+
+#include <StatRollupFile.hpp>
+#include <SoftStat.hpp>
+#include <ErrorSystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+
+// block: magic, number of strings, number of records, payload size, payload
+// payload: strings (uint32 length + data), records (bucket, count, six string indexes)
+// all numbers are in the big-endian byte order
+#define ROLLUP_MAGIC        "AMSR"
+#define ROLLUP_HEADER_SIZE  16
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CStatRollupKey::CStatRollupKey(void)
+{
+    Bucket = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void CStatRollupKey::SetFromDatagram(const CAddStatDatagram& datagram,int interval)
+{
+    int64_t time = (unsigned int)datagram.GetTime();
+    if( interval > 0 ){
+        Bucket = time - time % interval;
+    } else {
+        Bucket = time;
+    }
+    Site        = (const char*)datagram.GetSite();
+    ModuleName  = (const char*)datagram.GetModuleName();
+    ModuleVers  = (const char*)datagram.GetModuleVers();
+    ModuleArch  = (const char*)datagram.GetModuleArch();
+    ModuleMode  = (const char*)datagram.GetModuleMode();
+    HostGroup   = (const char*)datagram.GetHostGroup();
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatRollupKey::operator == (const CStatRollupKey& right) const
+{
+    return( (Bucket == right.Bucket) && (ModuleName == right.ModuleName) &&
+            (ModuleVers == right.ModuleVers) && (ModuleArch == right.ModuleArch) &&
+            (ModuleMode == right.ModuleMode) && (HostGroup == right.HostGroup) &&
+            (Site == right.Site) );
+}
+
+//------------------------------------------------------------------------------
+
+size_t CStatRollupKeyHash::operator()(const CStatRollupKey& key) const
+{
+    std::hash<std::string> hasher;
+    size_t seed = std::hash<int64_t>()(key.Bucket);
+    seed ^= hasher(key.Site)       + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hasher(key.ModuleName) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hasher(key.ModuleVers) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hasher(key.ModuleArch) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hasher(key.ModuleMode) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hasher(key.HostGroup)  + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return(seed);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CStatRollupFile::AppendBlock(const CFileName& name,const CStatRollupMap& rollups)
+{
+    if( rollups.empty() ) return(true);
+
+    // string table - module names, archs, and host groups repeat a lot
+    std::unordered_map<std::string,uint32_t>    string_ids;
+    std::string                                 strings;
+    std::string                                 records;
+
+    auto add_string = [&](const std::string& str){
+        auto it = string_ids.find(str);
+        if( it != string_ids.end() ) return(it->second);
+        uint32_t id = string_ids.size();
+        string_ids[str] = id;
+        WriteUInt32(strings,str.size());
+        strings.append(str);
+        return(id);
+    };
+
+    for(const auto& rollup : rollups){
+        WriteUInt64(records,rollup.first.Bucket);
+        WriteUInt64(records,rollup.second);
+        WriteUInt32(records,add_string(rollup.first.Site));
+        WriteUInt32(records,add_string(rollup.first.ModuleName));
+        WriteUInt32(records,add_string(rollup.first.ModuleVers));
+        WriteUInt32(records,add_string(rollup.first.ModuleArch));
+        WriteUInt32(records,add_string(rollup.first.ModuleMode));
+        WriteUInt32(records,add_string(rollup.first.HostGroup));
+    }
+
+    std::string block(ROLLUP_MAGIC);
+    WriteUInt32(block,string_ids.size());
+    WriteUInt32(block,rollups.size());
+    WriteUInt32(block,strings.size() + records.size());
+    block.append(strings);
+    block.append(records);
+
+    // the block is written by a single write call
+    std::ofstream ofs((const char*)name,std::ios::out | std::ios::app | std::ios::binary);
+    if( ! ofs ){
+        CSmallString error;
+        error << "unable to open rollup file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+    ofs.write(block.data(),block.size());
+    ofs.close();
+    if( ! ofs ){
+        CSmallString error;
+        error << "unable to append block into rollup file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatRollupFile::ReadRecords(const CFileName& name,
+                                  const std::function<void(const CStatRollupKey&,uint64_t)>& callback)
+{
+    std::ifstream ifs((const char*)name,std::ios::in | std::ios::binary);
+    if( ! ifs ){
+        CSmallString error;
+        error << "unable to open rollup file '" << name << "'";
+        ES_ERROR(error);
+        return(false);
+    }
+    std::string data((std::istreambuf_iterator<char>(ifs)),std::istreambuf_iterator<char>());
+
+    const char* p_data = data.data();
+    const char* p_end = p_data + data.size();
+
+    while( p_data < p_end ){
+        uint32_t nstrings,nrecords,size;
+        if( (p_end - p_data < ROLLUP_HEADER_SIZE) || (memcmp(p_data,ROLLUP_MAGIC,4) != 0) ){
+            ES_WARNING("corrupted or truncated block in rollup file, ignoring the rest");
+            return(true);
+        }
+        p_data += 4;
+        ReadUInt32(p_data,p_end,nstrings);
+        ReadUInt32(p_data,p_end,nrecords);
+        ReadUInt32(p_data,p_end,size);
+        if( (size_t)(p_end - p_data) < size ){
+            ES_WARNING("truncated block in rollup file, ignoring it");
+            return(true);
+        }
+        const char* p_block_end = p_data + size;
+
+        std::vector<std::string> strings;
+        strings.reserve(nstrings);
+        for(uint32_t i=0; i < nstrings; i++){
+            uint32_t len;
+            if( (ReadUInt32(p_data,p_block_end,len) == false) || ((size_t)(p_block_end - p_data) < len) ){
+                ES_ERROR("corrupted string table in rollup file");
+                return(false);
+            }
+            strings.push_back(std::string(p_data,len));
+            p_data += len;
+        }
+
+        for(uint32_t i=0; i < nrecords; i++){
+            CStatRollupKey  key;
+            uint64_t        bucket,count;
+            bool            result = true;
+            result &= ReadUInt64(p_data,p_block_end,bucket);
+            result &= ReadUInt64(p_data,p_block_end,count);
+            result &= ReadString(p_data,p_block_end,strings,key.Site);
+            result &= ReadString(p_data,p_block_end,strings,key.ModuleName);
+            result &= ReadString(p_data,p_block_end,strings,key.ModuleVers);
+            result &= ReadString(p_data,p_block_end,strings,key.ModuleArch);
+            result &= ReadString(p_data,p_block_end,strings,key.ModuleMode);
+            result &= ReadString(p_data,p_block_end,strings,key.HostGroup);
+            if( result == false ){
+                ES_ERROR("corrupted record in rollup file");
+                return(false);
+            }
+            key.Bucket = bucket;
+            callback(key,count);
+        }
+
+        p_data = p_block_end;
+    }
+
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+void CStatRollupFile::WriteUInt32(std::string& out,uint32_t value)
+{
+    out.push_back((char)((value >> 24) & 0xFF));
+    out.push_back((char)((value >> 16) & 0xFF));
+    out.push_back((char)((value >>  8) & 0xFF));
+    out.push_back((char)((value      ) & 0xFF));
+}
+
+//------------------------------------------------------------------------------
+
+void CStatRollupFile::WriteUInt64(std::string& out,uint64_t value)
+{
+    WriteUInt32(out,value >> 32);
+    WriteUInt32(out,value & 0xFFFFFFFF);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatRollupFile::ReadUInt32(const char*& p_data,const char* p_end,uint32_t& value)
+{
+    if( p_end - p_data < 4 ) return(false);
+    const unsigned char* p_udata = (const unsigned char*)p_data;
+    value = ((uint32_t)p_udata[0] << 24) | ((uint32_t)p_udata[1] << 16)
+          | ((uint32_t)p_udata[2] << 8) | (uint32_t)p_udata[3];
+    p_data += 4;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatRollupFile::ReadUInt64(const char*& p_data,const char* p_end,uint64_t& value)
+{
+    uint32_t hi,lo;
+    if( ReadUInt32(p_data,p_end,hi) == false ) return(false);
+    if( ReadUInt32(p_data,p_end,lo) == false ) return(false);
+    value = ((uint64_t)hi << 32) | lo;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatRollupFile::ReadString(const char*& p_data,const char* p_end,
+                                 const std::vector<std::string>& strings,std::string& value)
+{
+    uint32_t id;
+    if( ReadUInt32(p_data,p_end,id) == false ) return(false);
+    if( id >= strings.size() ) return(false);
+    value = strings[id];
+    return(true);
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
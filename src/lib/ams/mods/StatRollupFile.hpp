@@ -0,0 +1,99 @@
+#ifndef StatRollupFileH
+#define StatRollupFileH
+// -----------------------------------------------------------------------------
+//     Copyright (C) 2024 Petr Kulhanek (kulhanek@chemi.muni.cz)
+//
+//     This library is free software; you can redistribute it and/or
+//     modify it under the terms of the GNU Lesser General Public
+//     License as published by the Free Software Foundation; either
+//     version 2.1 of the License, or (at your option) any later version.
+//
+//     This library is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//     Lesser General Public License for more details.
+//
+//     You should have received a copy of the GNU Lesser General Public
+//     License along with this library; if not, write to the Free Software
+//     Foundation, Inc., 51 Franklin Street, Fifth Floor,
+//     Boston, MA  02110-1301  USA
+// =============================================================================
+
+// =============================================================================
+
+#include <AMSMainHeader.hpp>
+#include <FileName.hpp>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+
+class CAddStatDatagram;
+
+//------------------------------------------------------------------------------
+
+/// aggregation key of module usage statistics
+
+class AMS_PACKAGE CStatRollupKey {
+public:
+    CStatRollupKey(void);
+
+    /// set key from datagram, the time is rounded down to the bucket
+    void SetFromDatagram(const CAddStatDatagram& datagram,int interval);
+
+    bool operator == (const CStatRollupKey& right) const;
+
+// section of public data ------------------------------------------------------
+public:
+    int64_t         Bucket;         // start of time bucket in seconds from epoch
+    std::string     Site;
+    std::string     ModuleName;
+    std::string     ModuleVers;
+    std::string     ModuleArch;
+    std::string     ModuleMode;
+    std::string     HostGroup;
+};
+
+//------------------------------------------------------------------------------
+
+struct AMS_PACKAGE CStatRollupKeyHash {
+    size_t operator()(const CStatRollupKey& key) const;
+};
+
+//------------------------------------------------------------------------------
+
+typedef std::unordered_map<CStatRollupKey,uint64_t,CStatRollupKeyHash> CStatRollupMap;
+
+//------------------------------------------------------------------------------
+
+/// append-only storage of time-bucketed rollups
+/// the file is a sequence of independent blocks, each block contains
+/// a string table and records referencing it, a truncated last block
+/// (e.g. after crash) is ignored
+
+class AMS_PACKAGE CStatRollupFile {
+public:
+// executive methods -----------------------------------------------------------
+    /// append rollups as a new block
+    static bool AppendBlock(const CFileName& name,const CStatRollupMap& rollups);
+
+    /// read all records, the callback is called for each record
+    static bool ReadRecords(const CFileName& name,
+                            const std::function<void(const CStatRollupKey&,uint64_t)>& callback);
+
+// section of private data -----------------------------------------------------
+private:
+    static void WriteUInt32(std::string& out,uint32_t value);
+    static void WriteUInt64(std::string& out,uint64_t value);
+    static bool ReadUInt32(const char*& p_data,const char* p_end,uint32_t& value);
+    static bool ReadUInt64(const char*& p_data,const char* p_end,uint64_t& value);
+    static bool ReadString(const char*& p_data,const char* p_end,
+                           const std::vector<std::string>& strings,std::string& value);
+};
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -25,6 +25,7 @@
 #include <Shell.hpp>
 #include <SiteController.hpp>
 #include <ModCache.hpp>
+#include <AMSProfiler.hpp>
 #include <AMSRegistry.hpp>
 #include <HostGroup.hpp>
 #include <Host.hpp>
@@ -65,6 +66,8 @@ CAMSCompletion::CAMSCompletion(void)
 
 bool CAMSCompletion::InitCompletion(void)
 {
+    CAMSProfilerPhase phase("completion-init");
+
     // get completion data --------------------------
     CommandLine = CShell::GetSystemVariable("COMP_LINE");
     CSmallString tmp;
@@ -128,6 +131,8 @@ bool CAMSCompletion::InitCompletion(void)
 
 bool CAMSCompletion::GetSuggestions(void)
 {
+    CAMSProfilerPhase phase("completion-suggestions");
+
     // get suggestions according to command ---------
     if( GetCommand() == "site" ) {
         // what part should be completed?
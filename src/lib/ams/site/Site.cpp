@@ -40,6 +40,7 @@
 #include <iomanip>
 #include <SiteController.hpp>
 #include <ModCache.hpp>
+#include <AMSProfiler.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
@@ -355,6 +356,8 @@ void CSite::PrintAutoLoadedModules(CVerboseStr& vout,CXMLElement* p_ele,const CS
 
 bool CSite::ActivateSite(void)
 {
+    CAMSProfilerPhase phase("site-activate");
+
     if( HostGroup.IsSiteAllowed(GetName()) == false ) {
         CSmallString error;
         error << "site (" << GetName()
@@ -404,6 +407,8 @@ bool CSite::ActivateSite(void)
 
 bool CSite::DeactivateSite(void)
 {
+    CAMSProfilerPhase phase("site-deactivate");
+
     if( IsSiteActive() == false ) {
         ES_ERROR("only active site can be deactivated");
         return(false);
@@ -44,6 +44,8 @@
 #include <HostGroup.hpp>
 #include <SiteController.hpp>
 #include <Shell.hpp>
+#include <AMSProfiler.hpp>
+#include <AMSConfigSnapshot.hpp>
 
 //------------------------------------------------------------------------------
 
@@ -72,6 +74,8 @@ CUser::CUser(void)
 
 void CUser::InitUserConfig(void)
 {
+    CAMSProfilerPhase phase("user-config-load");
+
     ConfigName = AMSRegistry.GetUsersConfigFile();
 
     if( CFileSystem::IsFile(ConfigName) == false ){
@@ -81,10 +85,7 @@ void CUser::InitUserConfig(void)
         return;
     }
 
-    CXMLParser xml_parser;
-    xml_parser.SetOutputXMLNode(&Config);
-
-    if( xml_parser.Parse(ConfigName) == false ) {
+    if( AMSConfigSnapshot.LoadXMLFile(ConfigName,&Config) == false ) {
         CSmallString    error;
         error << "unable to load users configuration file '" << ConfigName << "'";
         RUNTIME_ERROR(error);
@@ -95,6 +96,8 @@ void CUser::InitUserConfig(void)
 
 void CUser::InitUser(void)
 {
+    CAMSProfilerPhase phase("user-init");
+
     InitPosixUser();
     InitAMSUser();
 }
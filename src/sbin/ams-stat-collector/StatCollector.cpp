@@ -0,0 +1,384 @@
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+// =============================================================================
+
+#include "StatCollector.hpp"
+#include <ErrorSystem.hpp>
+#include <SmallTimeAndDate.hpp>
+#include <SoftStat.hpp>
+#include <StatPacket.hpp>
+
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+MAIN_ENTRY(CStatCollector)
+
+//------------------------------------------------------------------------------
+
+// number of datagrams received by a single recvmmsg call
+#define RECV_BATCH_SIZE     64
+
+// receive buffer for a single packet, larger than both wire formats
+#define RECV_PACKET_SIZE    2048
+
+// requested size of socket receive buffer
+#define RECV_BUFFER_SIZE    (8*1024*1024)
+
+// set by signal handler, checked by workers at least once per second
+static std::atomic<bool> Terminated(false);
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CStatCollectorWorker::CStatCollectorWorker(void)
+    : Active(0),Acknowledged(0),NumOfReceived(0),NumOfInvalid(0)
+{
+    Socket = -1;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CStatCollector::CStatCollector(void)
+{
+    Interval = 0;
+}
+
+//------------------------------------------------------------------------------
+
+int CStatCollector::Init(int argc, char* argv[])
+{
+    // encode program options
+    int result = Options.ParseCmdLine(argc,argv);
+
+    // should we exit or was it error?
+    if( result != SO_CONTINUE ) return(result);
+
+    // attach text console to stdout
+    Console.Attach(stdout);
+
+    // attach verbose stream to terminal stream and set desired verbosity level
+    vout.Attach(Console);
+    if( Options.GetOptVerbose() ) {
+        vout.Verbosity(CVerboseStr::high);
+    } else {
+        vout.Verbosity(CVerboseStr::low);
+    }
+
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-stat-collector (AMS utility) started at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    vout << low;
+
+    return(SO_CONTINUE);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatCollector::Run(void)
+{
+    Interval = Options.GetOptInterval();
+
+    // open sockets - the kernel distributes datagrams among them
+    for(int i=0; i < Options.GetOptNumOfThreads(); i++){
+        std::unique_ptr<CStatCollectorWorker> p_worker(new CStatCollectorWorker);
+        p_worker->Socket = OpenSocket();
+        if( p_worker->Socket < 0 ){
+            for(auto& p_opened : Workers) close(p_opened->Socket);
+            return(false);
+        }
+        Workers.push_back(std::move(p_worker));
+    }
+
+    vout << endl;
+    vout << "# Listen on     : " << Options.GetOptListen() << ":" << Options.GetOptPort() << endl;
+    vout << "# Threads       : " << Options.GetOptNumOfThreads() << endl;
+    vout << "# Time bucket   : " << Interval << " s" << endl;
+    vout << "# Flush period  : " << Options.GetOptFlushPeriod() << " s" << endl;
+    vout << "# Storage       : " << Options.GetArgStorage() << endl;
+
+    // terminate gracefully on signals
+    struct sigaction sa;
+    memset(&sa,0,sizeof(sa));
+    sa.sa_handler = SignalHandler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,&sa,NULL);
+    sigaction(SIGTERM,&sa,NULL);
+    sigaction(SIGHUP,&sa,NULL);
+
+    for(auto& p_worker : Workers){
+        p_worker->Thread = std::thread(&CStatCollector::ReceiveDatagrams,this,p_worker.get());
+    }
+
+    // periodic flushes
+    bool    result = true;
+    time_t  last_flush = time(NULL);
+    while( Terminated == false ){
+        sleep(1);
+        if( time(NULL) - last_flush < Options.GetOptFlushPeriod() ) continue;
+        result &= FlushRollups(false);
+        last_flush = time(NULL);
+    }
+
+    vout << endl;
+    vout << "# Terminating ..." << endl;
+
+    for(auto& p_worker : Workers){
+        p_worker->Thread.join();
+        close(p_worker->Socket);
+    }
+
+    result &= FlushRollups(true);
+
+    uint64_t received = 0;
+    uint64_t invalid = 0;
+    for(auto& p_worker : Workers){
+        received += p_worker->NumOfReceived;
+        invalid += p_worker->NumOfInvalid;
+    }
+
+    vout << "# Valid records     : " << received << endl;
+    vout << "# Invalid packets   : " << invalid << endl;
+
+    return(result);
+}
+
+//------------------------------------------------------------------------------
+
+void CStatCollector::Finalize(void)
+{
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-stat-collector (AMS utility) terminated at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    if( ErrorSystem.IsError() || (ErrorSystem.IsAnyRecord() && Options.GetOptVerbose()) ){
+        vout << low;
+        ErrorSystem.PrintErrors(vout);
+    }
+
+    vout << endl;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+int CStatCollector::OpenSocket(void)
+{
+    in_addr addr;
+    if( inet_aton(Options.GetOptListen(),&addr) == 0 ){
+        CSmallString error;
+        error << "invalid listen address '" << Options.GetOptListen() << "'";
+        ES_ERROR(error);
+        return(-1);
+    }
+
+    int sfd = socket(AF_INET,SOCK_DGRAM,0);
+    if( sfd == -1 ){
+        CSmallString error;
+        error << "unable to create socket (" << strerror(errno) << ")";
+        ES_ERROR(error);
+        return(-1);
+    }
+
+    int on = 1;
+    setsockopt(sfd,SOL_SOCKET,SO_REUSEADDR,&on,sizeof(on));
+#ifdef SO_REUSEPORT
+    setsockopt(sfd,SOL_SOCKET,SO_REUSEPORT,&on,sizeof(on));
+#endif
+
+    // large buffer absorbs bursts, e.g. when a large array job starts
+    int bufsize = RECV_BUFFER_SIZE;
+    setsockopt(sfd,SOL_SOCKET,SO_RCVBUF,&bufsize,sizeof(bufsize));
+
+    // workers must periodically check termination and acknowledge map flips
+    timeval timeout;
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    setsockopt(sfd,SOL_SOCKET,SO_RCVTIMEO,&timeout,sizeof(timeout));
+
+    sockaddr_in server_addr;
+    memset(&server_addr,0,sizeof(server_addr));
+    server_addr.sin_family  = AF_INET;
+    server_addr.sin_port    = htons(Options.GetOptPort());
+    server_addr.sin_addr    = addr;
+
+    if( bind(sfd,(sockaddr*)&server_addr,sizeof(server_addr)) == -1 ){
+        CSmallString error;
+        error << "unable to bind socket to " << Options.GetOptListen() << ":"
+              << Options.GetOptPort() << " (" << strerror(errno) << ")";
+        ES_ERROR(error);
+        close(sfd);
+        return(-1);
+    }
+
+    return(sfd);
+}
+
+//------------------------------------------------------------------------------
+
+void CStatCollector::ReceiveDatagrams(CStatCollectorWorker* p_worker)
+{
+    // the worker must not use ErrorSystem, it is not thread safe
+
+    std::vector<char>               buffers(RECV_BATCH_SIZE*RECV_PACKET_SIZE);
+    mmsghdr                         msgs[RECV_BATCH_SIZE];
+    iovec                           iovecs[RECV_BATCH_SIZE];
+    CAddStatDatagram                datagram;
+    std::vector<CAddStatDatagram>   records;
+
+    memset(msgs,0,sizeof(msgs));
+    for(int i=0; i < RECV_BATCH_SIZE; i++){
+        iovecs[i].iov_base          = &buffers[i*RECV_PACKET_SIZE];
+        iovecs[i].iov_len           = RECV_PACKET_SIZE;
+        msgs[i].msg_hdr.msg_iov     = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+    }
+
+    CStatRollupKey key;
+
+    while( Terminated == false ){
+        int active = p_worker->Active.load(std::memory_order_acquire);
+        CStatRollupMap& rollups = p_worker->Rollups[active];
+
+        // wait for the first datagram, then take all already queued ones
+        int n = recvmmsg(p_worker->Socket,msgs,RECV_BATCH_SIZE,MSG_WAITFORONE,NULL);
+
+        for(int i=0; i < n; i++){
+            const char* p_data = &buffers[i*RECV_PACKET_SIZE];
+            size_t      size = msgs[i].msg_len;
+
+            if( msgs[i].msg_hdr.msg_flags & MSG_TRUNC ){
+                p_worker->NumOfInvalid.fetch_add(1,std::memory_order_relaxed);
+                continue;
+            }
+
+            // v2 - several records per packet
+            if( CStatPacket::IsPacket(p_data,size) ){
+                if( CStatPacket::DecodePacket(p_data,size,records) == false ){
+                    p_worker->NumOfInvalid.fetch_add(1,std::memory_order_relaxed);
+                    continue;
+                }
+                for(const CAddStatDatagram& record : records){
+                    key.SetFromDatagram(record,Interval);
+                    rollups[key]++;
+                }
+                p_worker->NumOfReceived.fetch_add(records.size(),std::memory_order_relaxed);
+                continue;
+            }
+
+            // v1 - fixed datagram
+            if( size != sizeof(CAddStatDatagram) ){
+                p_worker->NumOfInvalid.fetch_add(1,std::memory_order_relaxed);
+                continue;
+            }
+            memcpy(&datagram,p_data,size);
+            if( datagram.CheckIntegrity() == false ){
+                p_worker->NumOfInvalid.fetch_add(1,std::memory_order_relaxed);
+                continue;
+            }
+            key.SetFromDatagram(datagram,Interval);
+            rollups[key]++;
+            p_worker->NumOfReceived.fetch_add(1,std::memory_order_relaxed);
+        }
+
+        // the map is not touched until the next flip is noticed
+        p_worker->Acknowledged.store(active,std::memory_order_release);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatCollector::FlushRollups(bool final)
+{
+    CStatRollupMap rollups;
+
+    for(auto& p_worker : Workers){
+        if( final == true ){
+            // workers are already joined
+            for(int i=0; i < 2; i++){
+                for(const auto& rollup : p_worker->Rollups[i]) rollups[rollup.first] += rollup.second;
+                p_worker->Rollups[i].clear();
+            }
+            continue;
+        }
+
+        int old = p_worker->Active.load(std::memory_order_relaxed);
+        p_worker->Active.store(1-old,std::memory_order_release);
+
+        // the worker acknowledges the flip within the receive timeout
+        while( p_worker->Acknowledged.load(std::memory_order_acquire) != 1-old ){
+            if( Terminated == true ) break;
+            usleep(10000);
+        }
+        if( p_worker->Acknowledged.load(std::memory_order_acquire) != 1-old ){
+            // terminated - the map will be collected by the final flush
+            continue;
+        }
+
+        for(const auto& rollup : p_worker->Rollups[old]) rollups[rollup.first] += rollup.second;
+        p_worker->Rollups[old].clear();
+    }
+
+    if( rollups.empty() ) return(true);
+
+    vout << high;
+    vout << "  > appending " << rollups.size() << " rollups" << endl;
+    vout << low;
+
+    return(CStatRollupFile::AppendBlock(Options.GetArgStorage(),rollups));
+}
+
+//------------------------------------------------------------------------------
+
+void CStatCollector::SignalHandler(int signum)
+{
+    Terminated = true;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,94 @@
+#ifndef StatCollectorH
+#define StatCollectorH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+// =============================================================================
+
+#include "StatCollectorOptions.hpp"
+#include <VerboseStr.hpp>
+#include <TerminalStr.hpp>
+#include <StatRollupFile.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+
+// -----------------------------------------------------------------------------
+
+/// receiving thread
+/// each worker owns its socket (SO_REUSEPORT) and two rollup maps, it aggregates
+/// into the active one without any locking, the main thread flips the active map
+/// and takes the inactive one after the worker acknowledges the flip
+
+class CStatCollectorWorker {
+public:
+    CStatCollectorWorker(void);
+
+    int                     Socket;
+    std::thread             Thread;
+    CStatRollupMap          Rollups[2];
+    std::atomic<int>        Active;         // map used by the worker
+    std::atomic<int>        Acknowledged;   // map used in the last finished batch
+    std::atomic<uint64_t>   NumOfReceived;
+    std::atomic<uint64_t>   NumOfInvalid;
+};
+
+// -----------------------------------------------------------------------------
+
+class CStatCollector {
+public:
+// constructor -----------------------------------------------------------------
+    CStatCollector(void);
+
+// main methods ----------------------------------------------------------------
+    /// init options
+    int Init(int argc,char* argv[]);
+
+    /// main part of program
+    bool Run(void);
+
+    /// finalize
+    void Finalize(void);
+
+// section of private data -----------------------------------------------------
+private:
+    CStatCollectorOptions   Options;
+    CTerminalStr            Console;
+    CVerboseStr             vout;
+
+    std::vector< std::unique_ptr<CStatCollectorWorker> >    Workers;
+    int                     Interval;
+
+    /// open socket bound to the listen address
+    int OpenSocket(void);
+
+    /// receive datagrams
+    void ReceiveDatagrams(CStatCollectorWorker* p_worker);
+
+    /// collect rollups from workers and append them into the storage
+    bool FlushRollups(bool final);
+
+    /// signal handler
+    static void SignalHandler(int signum);
+};
+
+// -----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef StatCollectorOptionsH
+#define StatCollectorOptionsH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+// =============================================================================
+
+#include <SimpleOptions.hpp>
+#include <AMSMainHeader.hpp>
+
+//------------------------------------------------------------------------------
+
+class CStatCollectorOptions : public CSimpleOptions {
+public:
+    // constructor - tune option setup
+    CStatCollectorOptions(void);
+
+    // program name and description -----------------------------------------------
+    CSO_PROG_NAME_BEGIN
+    "ams-stat-collector"
+    CSO_PROG_NAME_END
+
+    CSO_PROG_DESC_BEGIN
+    "Receive module usage datagrams (both v1 and v2 formats) sent by AMS commands, validate them, and aggregate them per site, module, "
+    "version, architecture, mode, and host group into time buckets. Rollups are periodically appended "
+    "into the storage file, which can be queried by ams-stat-query. The collector listens "
+    "only on the loopback interface by default."
+    CSO_PROG_DESC_END
+
+    CSO_PROG_VERS_BEGIN
+    LibBuildVersion_AMS
+    CSO_PROG_VERS_END
+
+    // list of all options and arguments ------------------------------------------
+    CSO_LIST_BEGIN
+    // args ---------------------------------
+    CSO_ARG(CSmallString,Storage)
+    // options ------------------------------
+    CSO_OPT(CSmallString,Listen)
+    CSO_OPT(int,Port)
+    CSO_OPT(int,NumOfThreads)
+    CSO_OPT(int,Interval)
+    CSO_OPT(int,FlushPeriod)
+    CSO_OPT(bool,Help)
+    CSO_OPT(bool,Version)
+    CSO_OPT(bool,Verbose)
+    CSO_LIST_END
+
+    CSO_MAP_BEGIN
+    //----------------------------------------------------------------------
+    CSO_MAP_ARG(CSmallString,                   /* argument type */
+                Storage,                        /* argument name */
+                NULL,                           /* default value */
+                true,                           /* is argument mandatory */
+                "storage",                      /* parametr name */
+                "name of the rollup storage file, new blocks are appended into it")   /* argument description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                Listen,                         /* option name */
+                "127.0.0.1",                    /* default value */
+                false,                          /* is option mandatory */
+                'l',                            /* short option name */
+                "listen",                       /* long option name */
+                "ADDR",                         /* parametr name */
+                "IPv4 address to listen on, use 0.0.0.0 for all interfaces")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                Port,                           /* option name */
+                32597,                          /* default value */
+                false,                          /* is option mandatory */
+                'p',                            /* short option name */
+                "port",                         /* long option name */
+                "PORT",                         /* parametr name */
+                "UDP port to listen on")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                NumOfThreads,                   /* option name */
+                2,                              /* default value */
+                false,                          /* is option mandatory */
+                't',                            /* short option name */
+                "threads",                      /* long option name */
+                "NUM",                          /* parametr name */
+                "number of receiving threads")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                Interval,                       /* option name */
+                3600,                           /* default value */
+                false,                          /* is option mandatory */
+                'i',                            /* short option name */
+                "interval",                     /* long option name */
+                "SEC",                          /* parametr name */
+                "length of time bucket in seconds")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                FlushPeriod,                    /* option name */
+                60,                             /* default value */
+                false,                          /* is option mandatory */
+                'f',                            /* short option name */
+                "flush",                        /* long option name */
+                "SEC",                          /* parametr name */
+                "how often rollups are appended into the storage in seconds")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Verbose,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'v',                            /* short option name */
+                "verbose",                      /* long option name */
+                NULL,                           /* parametr name */
+                "increase output verbosity")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Version,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                '\0',                           /* short option name */
+                "version",                      /* long option name */
+                NULL,                           /* parametr name */
+                "output version information and exit")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Help,                           /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'h',                            /* short option name */
+                "help",                         /* long option name */
+                NULL,                           /* parametr name */
+                "display this help and exit")   /* option description */
+    CSO_MAP_END
+
+// final operation with options ------------------------------------------------
+private:
+    virtual int CheckOptions(void);
+    virtual int FinalizeOptions(void);
+    virtual int CheckArguments(void);
+};
+
+//------------------------------------------------------------------------------
+
+#endif
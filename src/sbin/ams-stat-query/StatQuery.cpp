@@ -0,0 +1,309 @@
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+// =============================================================================
+
+#include "StatQuery.hpp"
+#include <ErrorSystem.hpp>
+#include <SmallTimeAndDate.hpp>
+#include <iomanip>
+#include <algorithm>
+#include <fnmatch.h>
+#include <time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+
+//------------------------------------------------------------------------------
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+
+MAIN_ENTRY(CStatQuery)
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+CStatQuery::CStatQuery(void)
+{
+    From = 0;
+    To = 0;
+}
+
+//------------------------------------------------------------------------------
+
+int CStatQuery::Init(int argc, char* argv[])
+{
+    // encode program options
+    int result = Options.ParseCmdLine(argc,argv);
+
+    // should we exit or was it error?
+    if( result != SO_CONTINUE ) return(result);
+
+    // attach text console to stdout
+    Console.Attach(stdout);
+
+    // attach verbose stream to terminal stream and set desired verbosity level
+    vout.Attach(Console);
+    if( Options.GetOptVerbose() ) {
+        vout.Verbosity(CVerboseStr::high);
+    } else {
+        vout.Verbosity(CVerboseStr::low);
+    }
+
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-stat-query (AMS utility) started at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    vout << low;
+
+    return(SO_CONTINUE);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatQuery::Run(void)
+{
+    if( ParseFields(Options.GetOptGroupBy()) == false ) return(false);
+
+    if( Options.GetOptFrom() != NULL ){
+        if( ParseTime(Options.GetOptFrom(),From) == false ) return(false);
+    }
+    if( Options.GetOptTo() != NULL ){
+        if( ParseTime(Options.GetOptTo(),To) == false ) return(false);
+    }
+
+    bool result = CStatRollupFile::ReadRecords(Options.GetArgStorage(),
+                    [this](const CStatRollupKey& key,uint64_t count){ AddRecord(key,count); });
+    if( result == false ){
+        ES_TRACE_ERROR("unable to read rollups");
+        return(false);
+    }
+
+    PrintGroups();
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+void CStatQuery::Finalize(void)
+{
+    CSmallTimeAndDate dt;
+    dt.GetActualTimeAndDate();
+
+    vout << high;
+    vout << endl;
+    vout << "# ==============================================================================" << endl;
+    vout << "# ams-stat-query (AMS utility) terminated at " << dt.GetSDateAndTime() << endl;
+    vout << "# ==============================================================================" << endl;
+
+    if( ErrorSystem.IsError() || (ErrorSystem.IsAnyRecord() && Options.GetOptVerbose()) ){
+        vout << low;
+        ErrorSystem.PrintErrors(vout);
+    }
+
+    vout << endl;
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
+
+bool CStatQuery::ParseFields(const CSmallString& fields)
+{
+    std::string         sfields(fields);
+    std::vector<string> names;
+    boost::split(names,sfields,boost::is_any_of(","),boost::token_compress_on);
+
+    for(const std::string& name : names){
+        if( name.empty() ) continue;
+        if( name == "time" ){
+            Fields.push_back(EF_TIME);
+        } else if( name == "site" ){
+            Fields.push_back(EF_SITE);
+        } else if( name == "module" ){
+            Fields.push_back(EF_MODULE);
+        } else if( name == "vers" ){
+            Fields.push_back(EF_VERS);
+        } else if( name == "arch" ){
+            Fields.push_back(EF_ARCH);
+        } else if( name == "mode" ){
+            Fields.push_back(EF_MODE);
+        } else if( name == "hostgroup" ){
+            Fields.push_back(EF_HOSTGROUP);
+        } else {
+            CSmallString error;
+            error << "unsupported field '" << name.c_str() << "'";
+            ES_ERROR(error);
+            return(false);
+        }
+    }
+
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+bool CStatQuery::ParseTime(const CSmallString& stime,int64_t& time)
+{
+    std::string str(stime);
+    if( (str.empty() == false) && (str.find_first_not_of("0123456789") == std::string::npos) ){
+        time = atoll(str.c_str());
+        return(true);
+    }
+
+    const char* formats[] = {"%Y-%m-%d %H:%M", "%Y-%m-%d", NULL};
+    for(int i=0; formats[i] != NULL; i++){
+        struct tm   tm;
+        memset(&tm,0,sizeof(tm));
+        const char* p_end = strptime(str.c_str(),formats[i],&tm);
+        if( (p_end == NULL) || (*p_end != '\0') ) continue;
+        tm.tm_isdst = -1;
+        time = mktime(&tm);
+        return(true);
+    }
+
+    CSmallString error;
+    error << "unable to parse time '" << stime << "'";
+    ES_ERROR(error);
+    return(false);
+}
+
+//------------------------------------------------------------------------------
+
+void CStatQuery::AddRecord(const CStatRollupKey& key,uint64_t count)
+{
+    if( (Options.GetOptFrom() != NULL) && (key.Bucket < From) ) return;
+    if( (Options.GetOptTo() != NULL) && (key.Bucket >= To) ) return;
+    if( (Options.GetOptSite() != NULL) && (fnmatch(Options.GetOptSite(),key.Site.c_str(),0) != 0) ) return;
+    if( (Options.GetOptModule() != NULL) && (fnmatch(Options.GetOptModule(),key.ModuleName.c_str(),0) != 0) ) return;
+    if( (Options.GetOptHostGroup() != NULL) && (fnmatch(Options.GetOptHostGroup(),key.HostGroup.c_str(),0) != 0) ) return;
+
+    std::vector<std::string> group;
+    for(EField field : Fields){
+        group.push_back(GetFieldValue(field,key));
+    }
+    Groups[group] += count;
+}
+
+//------------------------------------------------------------------------------
+
+void CStatQuery::PrintGroups(void)
+{
+    typedef std::pair<std::vector<std::string>,uint64_t> TGroup;
+    std::vector<TGroup> groups(Groups.begin(),Groups.end());
+
+    // the most used first, then alphabetically
+    std::sort(groups.begin(),groups.end(),[](const TGroup& left,const TGroup& right){
+        if( left.second != right.second ) return(left.second > right.second);
+        return(left.first < right.first);
+    });
+
+    if( (Options.GetOptLimit() > 0) && ((int)groups.size() > Options.GetOptLimit()) ){
+        groups.resize(Options.GetOptLimit());
+    }
+
+    // column widths
+    std::vector<size_t> widths;
+    uint64_t            total = 0;
+    for(EField field : Fields){
+        widths.push_back(strlen(GetFieldName(field)));
+    }
+    for(const TGroup& group : groups){
+        for(size_t i=0; i < widths.size(); i++){
+            widths[i] = std::max(widths[i],group.first[i].size());
+        }
+        total += group.second;
+    }
+
+    vout << endl;
+    vout << "#      Count";
+    for(size_t i=0; i < Fields.size(); i++){
+        vout << " " << left << setw(widths[i]) << GetFieldName(Fields[i]);
+    }
+    vout << right << endl;
+    vout << "# ----------";
+    for(size_t i=0; i < Fields.size(); i++){
+        vout << " " << std::string(widths[i],'-');
+    }
+    vout << endl;
+
+    for(const TGroup& group : groups){
+        vout << "  " << setw(10) << group.second;
+        for(size_t i=0; i < Fields.size(); i++){
+            vout << " " << left << setw(widths[i]) << group.first[i];
+        }
+        vout << right << endl;
+    }
+
+    vout << "# ----------" << endl;
+    vout << "  " << setw(10) << total << endl;
+}
+
+//------------------------------------------------------------------------------
+
+const char* CStatQuery::GetFieldName(EField field)
+{
+    switch(field){
+        case EF_TIME:       return("Time");
+        case EF_SITE:       return("Site");
+        case EF_MODULE:     return("Module");
+        case EF_VERS:       return("Version");
+        case EF_ARCH:       return("Architecture");
+        case EF_MODE:       return("Mode");
+        case EF_HOSTGROUP:  return("Host Group");
+    }
+    return("");
+}
+
+//------------------------------------------------------------------------------
+
+const std::string CStatQuery::GetFieldValue(EField field,const CStatRollupKey& key) const
+{
+    switch(field){
+        case EF_TIME: {
+            time_t      time = key.Bucket;
+            struct tm   tm;
+            char        buffer[64];
+            localtime_r(&time,&tm);
+            strftime(buffer,sizeof(buffer),"%Y-%m-%d %H:%M",&tm);
+            return(buffer);
+        }
+        case EF_SITE:       return(key.Site);
+        case EF_MODULE:     return(key.ModuleName);
+        case EF_VERS:       return(key.ModuleVers);
+        case EF_ARCH:       return(key.ModuleArch);
+        case EF_MODE:       return(key.ModuleMode);
+        case EF_HOSTGROUP:  return(key.HostGroup);
+    }
+    return("");
+}
+
+//==============================================================================
+//------------------------------------------------------------------------------
+//==============================================================================
@@ -0,0 +1,89 @@
+#ifndef StatQueryH
+#define StatQueryH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+// =============================================================================
+
+#include "StatQueryOptions.hpp"
+#include <VerboseStr.hpp>
+#include <TerminalStr.hpp>
+#include <StatRollupFile.hpp>
+#include <vector>
+#include <string>
+#include <map>
+
+// -----------------------------------------------------------------------------
+
+class CStatQuery {
+public:
+// constructor -----------------------------------------------------------------
+    CStatQuery(void);
+
+// main methods ----------------------------------------------------------------
+    /// init options
+    int Init(int argc,char* argv[]);
+
+    /// main part of program
+    bool Run(void);
+
+    /// finalize
+    void Finalize(void);
+
+// section of private data -----------------------------------------------------
+private:
+    CStatQueryOptions   Options;
+    CTerminalStr        Console;
+    CVerboseStr         vout;
+
+    enum EField {
+        EF_TIME,
+        EF_SITE,
+        EF_MODULE,
+        EF_VERS,
+        EF_ARCH,
+        EF_MODE,
+        EF_HOSTGROUP
+    };
+
+    std::vector<EField>                             Fields;
+    int64_t                                         From;
+    int64_t                                         To;
+    std::map<std::vector<std::string>,uint64_t>     Groups;
+
+    /// parse list of group fields
+    bool ParseFields(const CSmallString& fields);
+
+    /// parse date or seconds from epoch
+    static bool ParseTime(const CSmallString& stime,int64_t& time);
+
+    /// add record into groups if it passes filters
+    void AddRecord(const CStatRollupKey& key,uint64_t count);
+
+    /// print groups sorted by count
+    void PrintGroups(void);
+
+    /// get field name/value
+    static const char* GetFieldName(EField field);
+    const std::string GetFieldValue(EField field,const CStatRollupKey& key) const;
+};
+
+// -----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef StatQueryOptionsH
+#define StatQueryOptionsH
+// =============================================================================
+// AMS - Advanced Module System
+// -----------------------------------------------------------------------------
+//    Copyright (C) 2024      Petr Kulhanek, kulhanek@chemi.muni.cz
+//
+//     This program is free software; you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation; either version 2 of the License, or
+//     (at your option) any later version.
+//
+//     This program is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License along
+//     with this program; if not, write to the Free Software Foundation, Inc.,
+//     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+// =============================================================================
+// =============================================================================
+
+#include <SimpleOptions.hpp>
+#include <AMSMainHeader.hpp>
+
+//------------------------------------------------------------------------------
+
+class CStatQueryOptions : public CSimpleOptions {
+public:
+    // constructor - tune option setup
+    CStatQueryOptions(void);
+
+    // program name and description -----------------------------------------------
+    CSO_PROG_NAME_BEGIN
+    "ams-stat-query"
+    CSO_PROG_NAME_END
+
+    CSO_PROG_DESC_BEGIN
+    "Summarize module usage statistics stored by ams-stat-collector. Records are filtered by time and "
+    "optional patterns and grouped by selected fields (time, site, module, vers, arch, mode, hostgroup)."
+    CSO_PROG_DESC_END
+
+    CSO_PROG_VERS_BEGIN
+    LibBuildVersion_AMS
+    CSO_PROG_VERS_END
+
+    // list of all options and arguments ------------------------------------------
+    CSO_LIST_BEGIN
+    // args ---------------------------------
+    CSO_ARG(CSmallString,Storage)
+    // options ------------------------------
+    CSO_OPT(CSmallString,GroupBy)
+    CSO_OPT(CSmallString,From)
+    CSO_OPT(CSmallString,To)
+    CSO_OPT(CSmallString,Site)
+    CSO_OPT(CSmallString,Module)
+    CSO_OPT(CSmallString,HostGroup)
+    CSO_OPT(int,Limit)
+    CSO_OPT(bool,Help)
+    CSO_OPT(bool,Version)
+    CSO_OPT(bool,Verbose)
+    CSO_LIST_END
+
+    CSO_MAP_BEGIN
+    //----------------------------------------------------------------------
+    CSO_MAP_ARG(CSmallString,                   /* argument type */
+                Storage,                        /* argument name */
+                NULL,                           /* default value */
+                true,                           /* is argument mandatory */
+                "storage",                      /* parametr name */
+                "name of the rollup storage file")   /* argument description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                GroupBy,                        /* option name */
+                "module",                       /* default value */
+                false,                          /* is option mandatory */
+                'g',                            /* short option name */
+                "group",                        /* long option name */
+                "FIELDS",                       /* parametr name */
+                "comma separated list of fields: time, site, module, vers, arch, mode, hostgroup")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                From,                           /* option name */
+                NULL,                           /* default value */
+                false,                          /* is option mandatory */
+                'f',                            /* short option name */
+                "from",                         /* long option name */
+                "DATE",                         /* parametr name */
+                "include buckets starting at or after DATE (YYYY-MM-DD[ HH:MM] or seconds from epoch)")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                To,                             /* option name */
+                NULL,                           /* default value */
+                false,                          /* is option mandatory */
+                't',                            /* short option name */
+                "to",                           /* long option name */
+                "DATE",                         /* parametr name */
+                "include buckets starting before DATE (YYYY-MM-DD[ HH:MM] or seconds from epoch)")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                Site,                           /* option name */
+                NULL,                           /* default value */
+                false,                          /* is option mandatory */
+                's',                            /* short option name */
+                "site",                         /* long option name */
+                "PATTERN",                      /* parametr name */
+                "include only sites matching the pattern")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                Module,                         /* option name */
+                NULL,                           /* default value */
+                false,                          /* is option mandatory */
+                'm',                            /* short option name */
+                "module",                       /* long option name */
+                "PATTERN",                      /* parametr name */
+                "include only modules matching the pattern")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(CSmallString,                   /* option type */
+                HostGroup,                      /* option name */
+                NULL,                           /* default value */
+                false,                          /* is option mandatory */
+                'r',                            /* short option name */
+                "hostgroup",                    /* long option name */
+                "PATTERN",                      /* parametr name */
+                "include only host groups matching the pattern")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(int,                            /* option type */
+                Limit,                          /* option name */
+                0,                              /* default value */
+                false,                          /* is option mandatory */
+                'n',                            /* short option name */
+                "limit",                        /* long option name */
+                "NUM",                          /* parametr name */
+                "print only NUM most used entries, zero means all")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Verbose,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'v',                            /* short option name */
+                "verbose",                      /* long option name */
+                NULL,                           /* parametr name */
+                "increase output verbosity")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Version,                        /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                '\0',                           /* short option name */
+                "version",                      /* long option name */
+                NULL,                           /* parametr name */
+                "output version information and exit")   /* option description */
+    //----------------------------------------------------------------------
+    CSO_MAP_OPT(bool,                           /* option type */
+                Help,                           /* option name */
+                false,                          /* default value */
+                false,                          /* is option mandatory */
+                'h',                            /* short option name */
+                "help",                         /* long option name */
+                NULL,                           /* parametr name */
+                "display this help and exit")   /* option description */
+    CSO_MAP_END
+
+// final operation with options ------------------------------------------------
+private:
+    virtual int CheckOptions(void);
+    virtual int FinalizeOptions(void);
+    virtual int CheckArguments(void);
+};
+
+//------------------------------------------------------------------------------
+
+#endif